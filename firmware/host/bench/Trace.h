@@ -0,0 +1,167 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+#include "AnalogFilter.h"
+
+// Finger trace for the host harnesses (filter_lag, onset_latency)
+//
+// A trace is the R lines of RAW mode: R,<v0>,...,<vN-1>,<mapped...>. The
+// first SENSOR_COUNT fields are the filter-domain values (inverted, thumb
+// offset removed) and are taken as the true finger position; the rest is
+// ignored. Lines recorded in trace mode carry @line,seq,capture_us and are
+// placed at their capture time; other lines are spaced 1/rate apart.
+//
+// TraceReplay plays a trace into the real AnalogFilter: every simulated
+// ADC frame the synthetic source is set to the interpolated trace value
+// (back in the raw ADC domain) plus sensor noise, so the filters see what
+// the ADC engine would deliver.
+
+struct TraceSample {
+  uint32_t timeUs;
+  int value[SENSOR_COUNT];
+};
+
+class Trace {
+private:
+  std::vector<TraceSample> samples;
+
+public:
+  // False if the file can't be read or has no R lines
+  bool load(const char* path, uint32_t rateHz) {
+    FILE* f = fopen(path, "r");
+    if (!f) return false;
+    char line[512];
+    uint32_t firstUs = 0;
+    bool stamped = false;
+    while (fgets(line, sizeof(line), f)) {
+      if (strncmp(line, "R,", 2) != 0) continue;
+      TraceSample s;
+      char* at = strchr(line, '@');
+      if (at) {
+        *at = '\0';
+        unsigned long lineNo, seq, us;
+        if (sscanf(at + 1, "%lu,%lu,%lu", &lineNo, &seq, &us) == 3) {
+          if (!stamped) firstUs = (uint32_t)us;
+          stamped = true;
+          s.timeUs = (uint32_t)us - firstUs;
+        }
+      }
+      if (!at || !stamped) s.timeUs = (uint32_t)(samples.size() * (1000000UL / rateHz));
+
+      char* p = line + 2;
+      int n = 0;
+      while (n < SENSOR_COUNT && *p) {
+        char* end;
+        long v = strtol(p, &end, 10);
+        if (end == p) break;
+        s.value[n++] = (int)v;
+        p = (*end == ',') ? end + 1 : end;
+      }
+      if (n == SENSOR_COUNT) samples.push_back(s);
+    }
+    fclose(f);
+    return !samples.empty();
+  }
+
+  // Built-in trace: rest at 500, curls to 3500 and back over 80, 150 and
+  // 300 ms with 700 ms holds, each finger 100 ms after the previous one.
+  // A channel with an input offset (thumb) moves within the range left to it.
+  void synthesize(uint32_t rateHz) {
+    static const uint32_t rampsMs[] = {150, 80, 300, 150, 80, 300};
+    const uint32_t periodUs = 1000000UL / rateHz;
+    const uint32_t holdUs = 700000;
+    uint32_t lengthUs = 0;
+    for (uint32_t r : rampsMs) lengthUs += r * 1000 + holdUs;
+    lengthUs += holdUs + (SENSOR_COUNT - 1) * 100000UL;
+
+    samples.clear();
+    for (uint32_t t = 0; t <= lengthUs; t += periodUs) {
+      TraceSample s;
+      s.timeUs = t;
+      for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+        int32_t local = (int32_t)t - (int32_t)(holdUs + ch * 100000UL);
+        int level = 500;
+        bool closed = false;
+        for (uint32_t r : rampsMs) {
+          int32_t rampUs = (int32_t)(r * 1000);
+          if (local < 0) break;
+          int from = closed ? 3500 : 500;
+          int to = closed ? 500 : 3500;
+          level = local < rampUs ? from + (int)((int64_t)(to - from) * local / rampUs) : to;
+          local -= rampUs + (int32_t)holdUs;
+          closed = !closed;
+        }
+        int top = ANALOG_MAX - ThumbOffset::offset(ch) - 100;
+        if (top < 3500) level = top / 8 + (level - 500) * (top - top / 8) / 3000;
+        s.value[ch] = level;
+      }
+      samples.push_back(s);
+    }
+  }
+
+  void print() const {
+    for (const TraceSample& s : samples) {
+      printf("R");
+      for (int ch = 0; ch < SENSOR_COUNT; ch++) printf(",%d", s.value[ch]);
+      for (int ch = 0; ch < SENSOR_COUNT; ch++) printf(",%d", s.value[ch]);
+      printf("\n");
+    }
+  }
+
+  uint32_t lengthUs() const { return samples.empty() ? 0 : samples.back().timeUs; }
+
+  // Linear interpolation between the samples around tUs
+  int at(int ch, uint32_t tUs) const {
+    size_t lo = 0, hi = samples.size() - 1;
+    if (tUs <= samples[lo].timeUs) return samples[lo].value[ch];
+    if (tUs >= samples[hi].timeUs) return samples[hi].value[ch];
+    while (hi - lo > 1) {
+      size_t mid = (lo + hi) / 2;
+      if (samples[mid].timeUs <= tUs) lo = mid; else hi = mid;
+    }
+    const TraceSample& a = samples[lo];
+    const TraceSample& b = samples[hi];
+    return a.value[ch] + (int)((int64_t)(b.value[ch] - a.value[ch]) * (tUs - a.timeUs) /
+                                (b.timeUs - a.timeUs));
+  }
+};
+
+class TraceReplay {
+private:
+  AnalogFilter& filter;
+  const Trace& trace;
+  uint32_t startUs;
+
+public:
+  TraceReplay(AnalogFilter& f, const Trace& t, int noiseSigma) : filter(f), trace(t) {
+    SimulatedAdcBackend& backend = filter.getAdc().getBackend();
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      backend.getSource().setNoise(ch, noiseSigma);
+    }
+    startUs = backend.getTimer().now();
+  }
+
+  // Trace time of an ADC timestamp
+  uint32_t traceTime(uint32_t timestampUs) const { return timestampUs - startUs; }
+
+  bool done() const {
+    return traceTime(filter.getAdc().getBackend().getTimer().now()) >= trace.lengthUs();
+  }
+
+  // Run the ADC one frame period on the trace value due next
+  void step() {
+    SimulatedAdcBackend& backend = filter.getAdc().getBackend();
+    const uint32_t periodUs = 1000000UL / ADC_FRAME_RATE_HZ;
+    uint32_t t = traceTime(backend.getTimer().now() + periodUs);
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      int v = trace.at(ch, t) + filter.getInputOffset(ch);
+      if (filter.isInverted(ch)) v = ANALOG_MAX - v;
+      backend.getSource().setLevel(ch, v < 0 ? 0 : (v > ANALOG_MAX ? ANALOG_MAX : v));
+    }
+    backend.advance(periodUs);
+  }
+};
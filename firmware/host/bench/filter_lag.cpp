@@ -0,0 +1,171 @@
+// Lag vs. jitter of the AnalogFilter modes on a finger trace
+//
+// Replays a trace (see Trace.h) through the real AnalogFilter once per
+// filter mode and reads one stream, as the firmware would. For each mode:
+//   lag    - delay (ms) that best lines the output up with the trace:
+//            the shift minimising the squared error, fingers averaged
+//   jitter - RMS frame-to-frame output change (counts) while the trace
+//            has been at rest for 200 ms
+//
+//   ./filter_lag                          built-in trace (as traces/curl_100hz.txt)
+//   ./filter_lag traces/my_recording.txt  a recorded trace
+//   ./filter_lag --synth > trace.txt      write the built-in trace
+// Options: --rate <Hz> for unstamped traces (100), --noise <counts> sensor
+// noise added on replay (8), --stream full|gesture|host (host).
+//
+// Fails if a mode's output cannot be lined up with the trace within
+// MAX_LAG_MS, or if One-Euro or Kalman lag more than EMA. --check also
+// holds each mode to LIMITS, set for the built-in trace with the default
+// noise and stream (what ctest runs).
+
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "AnalogFilter.h"
+#include "Trace.h"
+#include "Check.h"
+
+OperationMode currentMode = MODE_HOME;
+Logger logger;
+
+static const uint32_t MAX_LAG_MS = 200;
+static const uint32_t REST_US = 200000;
+static const uint32_t WARMUP_US = 500000;
+
+struct Result {
+  double lagMs;
+  double jitter;            // RMS counts
+};
+
+// --check: measured lag / jitter with margin (EMA 41.0 / 0.24,
+// One-Euro 22.8 / 0.33, Kalman 4.0 / 0.71 when set)
+static const Result LIMITS[FILTER_MODE_COUNT] = {
+  {50, 0.5},                // EMA
+  {30, 0.5},                // One-Euro
+  {10, 1.0},                // Kalman
+};
+
+struct Output {
+  uint32_t timeUs;
+  int value[SENSOR_COUNT];
+};
+
+static Result run(FilterMode mode, const Trace& trace, int noise, SampleStream stream) {
+  AnalogFilter* filter = new AnalogFilter();
+  filter->begin();
+  filter->setMode(mode);
+  TraceReplay replay(*filter, trace, noise);
+
+  std::vector<Output> out;
+  while (!replay.done()) {
+    replay.step();
+    Output o;
+    while (filter->readFiltered(o.value, stream)) {
+      o.timeUs = replay.traceTime(filter->getLastTimestampUs());
+      if (o.timeUs >= WARMUP_US) out.push_back(o);
+    }
+  }
+
+  // Lag: best shift per finger
+  double lagSum = 0;
+  for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+    double bestError = -1;
+    uint32_t bestLag = 0;
+    for (uint32_t lag = 0; lag <= MAX_LAG_MS; lag++) {
+      double error = 0;
+      for (const Output& o : out) {
+        double d = o.value[ch] - trace.at(ch, o.timeUs - lag * 1000);
+        error += d * d;
+      }
+      if (bestError < 0 || error < bestError) {
+        bestError = error;
+        bestLag = lag;
+      }
+    }
+    lagSum += bestLag;
+  }
+
+  // Jitter: output changes while the finger has been still
+  double jitterSum = 0;
+  int jitterCount = 0;
+  for (size_t k = 1; k < out.size(); k++) {
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      uint32_t t = out[k].timeUs;
+      int now = trace.at(ch, t);
+      if (trace.at(ch, t - REST_US) != now || trace.at(ch, t - REST_US / 2) != now) continue;
+      double d = out[k].value[ch] - out[k - 1].value[ch];
+      jitterSum += d * d;
+      jitterCount++;
+    }
+  }
+
+  Result result;
+  result.lagMs = lagSum / SENSOR_COUNT;
+  result.jitter = jitterCount ? sqrt(jitterSum / jitterCount) : 0.0;
+  printf("%-10s %8.1f %10.2f %9u\n", filter->getModeName(), result.lagMs, result.jitter,
+         (unsigned)out.size());
+  delete filter;
+  return result;
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  uint32_t rate = 100;
+  int noise = 8;
+  SampleStream stream = STREAM_HOST;
+  bool synth = false;
+  bool check = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--synth") == 0) {
+      synth = true;
+    } else if (strcmp(argv[i], "--check") == 0) {
+      check = true;
+    } else if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+      rate = (uint32_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--noise") == 0 && i + 1 < argc) {
+      noise = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+      const char* s = argv[++i];
+      stream = strcmp(s, "full") == 0 ? STREAM_FULL : strcmp(s, "gesture") == 0 ? STREAM_GESTURE : STREAM_HOST;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (rate == 0) rate = 100;
+
+  Trace trace;
+  if (path) {
+    if (!trace.load(path, rate)) {
+      fprintf(stderr, "%s: no R lines\n", path);
+      return 1;
+    }
+  } else {
+    trace.synthesize(100);
+  }
+  if (synth) {
+    trace.print();
+    return 0;
+  }
+
+  printf("%s, %.1f s, noise %d counts, stream %u Hz\n", path ? path : "built-in trace",
+         trace.lengthUs() / 1e6, noise, AnalogFilter().getRate(stream));
+  printf("mode       lag (ms) jitter (rms)  outputs\n");
+  Result result[FILTER_MODE_COUNT];
+  for (int m = 0; m < FILTER_MODE_COUNT; m++) {
+    result[m] = run((FilterMode)m, trace, noise, stream);
+  }
+
+  for (int m = 0; m < FILTER_MODE_COUNT; m++) {
+    const char* name = AnalogFilter::modeName((FilterMode)m);
+    CHECK(result[m].lagMs < MAX_LAG_MS, "%s: output does not line up with the trace", name);
+    CHECK(m == FILTER_MODE_EMA || result[m].lagMs <= result[FILTER_MODE_EMA].lagMs,
+          "%s lags %.1f ms, more than EMA (%.1f ms)", name, result[m].lagMs, result[FILTER_MODE_EMA].lagMs);
+    if (check) {
+      CHECK(result[m].lagMs <= LIMITS[m].lagMs, "%s lag %.1f ms, limit %.0f", name, result[m].lagMs, LIMITS[m].lagMs);
+      CHECK(result[m].jitter <= LIMITS[m].jitter, "%s jitter %.2f, limit %.2f", name, result[m].jitter, LIMITS[m].jitter);
+    }
+  }
+  return checkResult();
+}
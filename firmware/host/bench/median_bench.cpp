@@ -0,0 +1,133 @@
+// Median stage cost per frame, MedianWindow vs. the old bubble sort
+//
+// 5 channels of a noisy random walk with occasional +800 spikes (thumb-like).
+// For each window size the incremental window is first checked sample for
+// sample against copying the window and bubble-sorting it, as
+// AnalogFilter::getMedian did, then both are timed. Prints ns per 5-channel
+// frame. --quick runs the check with a short signal and skips the timing.
+//
+//   ./median_bench
+
+#include <random>
+#include <chrono>
+#include <vector>
+#include <stdio.h>
+#include <string.h>
+#include "filter/MedianFilter.h"
+
+static const int CHANNELS = 5;
+static const int REPEATS = 20;
+
+static std::vector<int> signal;
+static bool quick = false;
+static int failures = 0;
+
+// The replaced implementation: copy the window, bubble sort, middle element
+template <int N>
+static int bubbleMedian(const int* window) {
+  int s[N];
+  for (int i = 0; i < N; i++) s[i] = window[i];
+  for (int i = 0; i < N - 1; i++) {
+    for (int j = 0; j < N - i - 1; j++) {
+      if (s[j] > s[j + 1]) {
+        int t = s[j];
+        s[j] = s[j + 1];
+        s[j + 1] = t;
+      }
+    }
+  }
+  return s[N / 2];
+}
+
+static double nsPerFrame(std::chrono::steady_clock::duration d) {
+  double frames = (double)REPEATS * signal.size() / CHANNELS;
+  return std::chrono::duration<double, std::nano>(d).count() / frames;
+}
+
+template <int N, bool UseNetwork>
+static void run() {
+  MedianWindow<N, UseNetwork> window[CHANNELS];
+  int ring[CHANNELS][N];
+  int next[CHANNELS] = {0};
+  memset(ring, 0, sizeof(ring));
+
+  for (size_t k = 0; k < signal.size(); k += CHANNELS) {
+    for (int c = 0; c < CHANNELS; c++) {
+      int v = signal[k + c];
+      window[c].push(v);
+      ring[c][next[c]] = v;
+      next[c] = (next[c] + 1) % N;
+      if (window[c].median() != bubbleMedian<N>(ring[c])) {
+        printf("N=%2d: median differs from bubble sort at frame %u\n", N, (unsigned)(k / CHANNELS));
+        failures++;
+        return;
+      }
+    }
+  }
+  if (quick) {
+    printf("N=%2d %s matches bubble sort\n", N, UseNetwork ? "network" : "window ");
+    return;
+  }
+
+  volatile int sink = 0;
+  MedianWindow<N, UseNetwork> timed[CHANNELS];
+  auto t0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < REPEATS; r++) {
+    for (size_t k = 0; k < signal.size(); k += CHANNELS) {
+      for (int c = 0; c < CHANNELS; c++) {
+        timed[c].push(signal[k + c]);
+        sink += timed[c].median();
+      }
+    }
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (int r = 0; r < REPEATS; r++) {
+    for (size_t k = 0; k < signal.size(); k += CHANNELS) {
+      for (int c = 0; c < CHANNELS; c++) {
+        ring[c][next[c]] = signal[k + c];
+        next[c] = (next[c] + 1) % N;
+        sink += bubbleMedian<N>(ring[c]);
+      }
+    }
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  (void)sink;
+
+  printf("%4d  %-8s %10.1f %12.1f\n", N, UseNetwork ? "network" : "window",
+         nsPerFrame(t1 - t0), nsPerFrame(t2 - t1));
+}
+
+int main(int argc, char** argv) {
+  quick = argc > 1 && strcmp(argv[1], "--quick") == 0;
+
+  std::mt19937 rng(1);
+  std::normal_distribution<double> noise(0, 20);
+  double level[CHANNELS];
+  for (int c = 0; c < CHANNELS; c++) level[c] = 2000;
+  int frames = quick ? 20000 : 200000;
+  for (int k = 0; k < frames; k++) {
+    for (int c = 0; c < CHANNELS; c++) {
+      level[c] += noise(rng) * 0.5;
+      int v = (int)(level[c] + noise(rng));
+      if (rng() % 50 == 0) v += 800;
+      signal.push_back(v < 0 ? 0 : (v > 4095 ? 4095 : v));
+    }
+  }
+
+  if (!quick) {
+    printf("ns per %d-channel frame\n", CHANNELS);
+    printf("   N  stage           new       bubble\n");
+  }
+  run<3, true>();
+  run<3, false>();
+  run<5, true>();
+  run<5, false>();
+  run<7, false>();
+  run<9, false>();
+  run<11, false>();
+  run<15, false>();
+  run<21, false>();
+  run<31, false>();
+
+  return failures ? 1 : 0;
+}
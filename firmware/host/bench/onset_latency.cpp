@@ -0,0 +1,191 @@
+// Onset-to-event latency of AirPiano, onset path vs. smooth path
+//
+// Replays a trace (see Trace.h, same options as filter_lag) through the
+// real AnalogFilter and feeds AirPiano single-note mode one FingerFrame per
+// stream output, with the calibration taken as identity. Run twice:
+//   onset  - frame.onset from readOnset(), as the firmware does
+//   smooth - frame.onset = the smoothed value, as before the onset path
+// For every crossing of the note thresholds in the trace it finds the
+// matching NOTE_ON / NOTE_OFF event on the bus and reports the time from
+// the crossing to the capture of the frame that fired it. Events with no
+// crossing to match (chatter) are counted. Fails if either path misses a
+// crossing or fires an extra event, or if the onset path is not at least
+// FASTER_BY times faster than the smooth path on average.
+//
+//   ./onset_latency [trace] [--rate <Hz>] [--noise <counts>] [--stream full|gesture|host]
+
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "AnalogFilter.h"
+#include "AirPiano.h"
+#include "Trace.h"
+#include "Check.h"
+
+OperationMode currentMode = MODE_PIANO_SINGLE;
+Logger logger;
+
+static const uint32_t EARLY_US = 20000;
+static const int FASTER_BY = 2;
+
+struct LatencyStats {
+  double onAvg, onMax;      // ms
+  double offAvg, offMax;
+  int missed, extra;
+};
+
+static const uint8_t FINGER_NOTES[FINGER_COUNT] = {NOTE_THUMB, NOTE_INDEX, NOTE_MIDDLE, NOTE_RING, NOTE_PINKY};
+
+struct NoteEvent {
+  bool on;
+  int finger;
+  uint32_t timeUs;
+};
+
+struct Recorder {
+  const TraceReplay* replay;
+  std::vector<NoteEvent> events;
+};
+
+static void record(const GloveEvent& event, void* arg) {
+  Recorder* r = static_cast<Recorder*>(arg);
+  for (int i = 0; i < FINGER_COUNT; i++) {
+    if (FINGER_NOTES[i] != event.piano.note) continue;
+    NoteEvent e = {event.type == EVENT_NOTE_ON, i, r->replay->traceTime(event.timestampUs)};
+    r->events.push_back(e);
+  }
+}
+
+// Threshold crossings of the trace itself, at 0.1 ms resolution
+static std::vector<NoteEvent> crossings(const Trace& trace) {
+  std::vector<NoteEvent> out;
+  for (int ch = 0; ch < FINGER_COUNT; ch++) {
+    bool on = false;
+    for (uint32_t t = 0; t <= trace.lengthUs(); t += 100) {
+      int v = trace.at(ch, t);
+      if (!on && v > PIANO_ON_THRESHOLD) on = true;
+      else if (on && v < PIANO_OFF_THRESHOLD) on = false;
+      else continue;
+      NoteEvent e = {on, ch, t};
+      out.push_back(e);
+    }
+  }
+  return out;
+}
+
+static LatencyStats run(bool onsetPath, const Trace& trace, int noise, SampleStream stream) {
+  AnalogFilter* filter = new AnalogFilter();
+  filter->begin();
+  TraceReplay replay(*filter, trace, noise);
+
+  Recorder recorder;
+  recorder.replay = &replay;
+  EventBus bus;
+  bus.subscribe(record, &recorder, EVENTS_PIANO);
+  AirPiano piano;
+  piano.setEventBus(&bus);
+
+  FingerFrame frame = {};
+  while (!replay.done()) {
+    replay.step();
+    int value[SENSOR_COUNT];
+    int onset[SENSOR_COUNT];
+    while (filter->readFiltered(value, stream)) {
+      filter->readOnset(onset);
+      frame.timestampUs = filter->getLastTimestampUs();
+      frame.seq++;
+      for (int i = 0; i < SENSOR_COUNT; i++) {
+        frame.position[i] = (int16_t)value[i];
+        frame.onset[i] = (int16_t)(onsetPath ? onset[i] : value[i]);
+      }
+      piano.process(frame, MODE_PIANO_SINGLE);
+    }
+  }
+
+  // Match each crossing to the first event of its kind from EARLY_US
+  // before it (noise can push a sample over the threshold a little early)
+  std::vector<NoteEvent> truth = crossings(trace);
+  std::vector<bool> used(recorder.events.size(), false);
+  double sum[2] = {0, 0};
+  int32_t worst[2] = {0, 0};
+  int matched[2] = {0, 0}, missed = 0;
+  for (const NoteEvent& c : truth) {
+    bool found = false;
+    for (size_t k = 0; k < recorder.events.size(); k++) {
+      const NoteEvent& e = recorder.events[k];
+      if (used[k] || e.finger != c.finger || e.on != c.on || e.timeUs + EARLY_US < c.timeUs) continue;
+      used[k] = true;
+      int32_t latency = (int32_t)(e.timeUs - c.timeUs);
+      sum[c.on] += latency;
+      if (latency > worst[c.on]) worst[c.on] = latency;
+      matched[c.on]++;
+      found = true;
+      break;
+    }
+    if (!found) missed++;
+  }
+  int extra = 0;
+  for (size_t k = 0; k < used.size(); k++) {
+    if (!used[k]) extra++;
+  }
+
+  LatencyStats stats;
+  stats.onAvg = matched[1] ? sum[1] / matched[1] / 1000 : 0.0;
+  stats.onMax = worst[1] / 1000.0;
+  stats.offAvg = matched[0] ? sum[0] / matched[0] / 1000 : 0.0;
+  stats.offMax = worst[0] / 1000.0;
+  stats.missed = missed;
+  stats.extra = extra;
+  printf("%-7s %9.1f %8.1f %10.1f %9.1f %7d %6d\n", onsetPath ? "onset" : "smooth",
+         stats.onAvg, stats.onMax, stats.offAvg, stats.offMax, missed, extra);
+  delete filter;
+  return stats;
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  uint32_t rate = 100;
+  int noise = 8;
+  SampleStream stream = STREAM_FULL;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+      rate = (uint32_t)atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--noise") == 0 && i + 1 < argc) {
+      noise = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--stream") == 0 && i + 1 < argc) {
+      const char* s = argv[++i];
+      stream = strcmp(s, "host") == 0 ? STREAM_HOST : strcmp(s, "gesture") == 0 ? STREAM_GESTURE : STREAM_FULL;
+    } else {
+      path = argv[i];
+    }
+  }
+  if (rate == 0) rate = 100;
+
+  Trace trace;
+  if (path) {
+    if (!trace.load(path, rate)) {
+      fprintf(stderr, "%s: no R lines\n", path);
+      return 1;
+    }
+  } else {
+    trace.synthesize(100);
+  }
+
+  printf("%s, %.1f s, noise %d counts, stream %u Hz, note on > %d, off < %d\n",
+         path ? path : "built-in trace", trace.lengthUs() / 1e6, noise,
+         AnalogFilter().getRate(stream), PIANO_ON_THRESHOLD, PIANO_OFF_THRESHOLD);
+  printf("latency in ms\n");
+  printf("path       on avg   on max    off avg   off max  missed  extra\n");
+  LatencyStats onset = run(true, trace, noise, stream);
+  LatencyStats smooth = run(false, trace, noise, stream);
+
+  CHECK(onset.missed == 0 && onset.extra == 0, "onset path: %d missed, %d extra", onset.missed, onset.extra);
+  CHECK(smooth.missed == 0 && smooth.extra == 0, "smooth path: %d missed, %d extra", smooth.missed, smooth.extra);
+  CHECK(onset.onAvg * FASTER_BY < smooth.onAvg, "note on: onset %.1f ms is not %dx faster than smooth %.1f ms",
+        onset.onAvg, FASTER_BY, smooth.onAvg);
+  CHECK(onset.offAvg * FASTER_BY < smooth.offAvg, "note off: onset %.1f ms is not %dx faster than smooth %.1f ms",
+        onset.offAvg, FASTER_BY, smooth.offAvg);
+  return checkResult();
+}
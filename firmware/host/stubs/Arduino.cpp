@@ -0,0 +1,55 @@
+#include "Arduino.h"
+#include <stdarg.h>
+#include <chrono>
+#include <thread>
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+static int analogLevel[64];
+
+HardwareSerial Serial;
+
+unsigned long micros() {
+  return (unsigned long)(uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+    std::chrono::steady_clock::now() - startTime).count();
+}
+
+unsigned long millis() { return micros() / 1000; }
+
+void delay(unsigned long ms) { std::this_thread::sleep_for(std::chrono::milliseconds(ms)); }
+
+void delayMicroseconds(unsigned int us) { std::this_thread::sleep_for(std::chrono::microseconds(us)); }
+
+int analogRead(int pin) { return (pin >= 0 && pin < 64) ? analogLevel[pin] : 0; }
+
+void hostSetAnalog(int pin, int value) {
+  if (pin >= 0 && pin < 64) analogLevel[pin] = value;
+}
+
+void analogReadResolution(int) {}
+void analogSetAttenuation(int) {}
+void pinMode(int, int) {}
+void digitalWrite(int, int) {}
+
+long map(long x, long inMin, long inMax, long outMin, long outMax) {
+  return (x - inMin) * (outMax - outMin) / (inMax - inMin) + outMin;
+}
+
+size_t Print::write(uint8_t c) { return fwrite(&c, 1, 1, stdout); }
+size_t Print::write(const uint8_t* data, size_t len) { return fwrite(data, 1, len, stdout); }
+size_t Print::print(const char* s) { return fputs(s, stdout) < 0 ? 0 : strlen(s); }
+size_t Print::println(const char* s) { return print(s) + print("\n"); }
+
+size_t Print::printf(const char* format, ...) {
+  va_list args;
+  va_start(args, format);
+  int n = vprintf(format, args);
+  va_end(args);
+  return n < 0 ? 0 : (size_t)n;
+}
+
+int Print::availableForWrite() { return 256; }
+void Print::flush() { fflush(stdout); }
+
+void HardwareSerial::begin(unsigned long) {}
+int HardwareSerial::available() { return 0; }
+int HardwareSerial::read() { return -1; }
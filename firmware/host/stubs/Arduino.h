@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <math.h>
+#include <cmath>
+#include <algorithm>
+
+// Host stand-in for the Arduino core
+//
+// Only what src/ uses off the board: time comes from std::chrono, Serial
+// writes to stdout, analogRead() returns a level the test sets. ESP32 and
+// ARDUINO stay undefined, so the headers pick their portable paths
+// (SimulatedAdcBackend, std::thread acquisition, Logger drained by service()).
+
+#define PROGMEM
+#define F(x) x
+#define IRAM_ATTR
+
+#define INPUT   0
+#define OUTPUT  1
+#define LOW     0
+#define HIGH    1
+#define ADC_11db 3
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+int analogRead(int pin);
+void analogReadResolution(int bits);
+void analogSetAttenuation(int attenuation);
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int value);
+
+long map(long x, long inMin, long inMax, long outMin, long outMax);
+
+template <class T, class L, class H>
+T constrain(T x, L low, H high) { return x < low ? low : (x > high ? high : x); }
+
+using std::min;
+using std::max;
+using std::abs;
+
+// Host only: value analogRead() returns for a pin
+void hostSetAnalog(int pin, int value);
+
+class Print {
+public:
+  size_t write(uint8_t c);
+  size_t write(const uint8_t* data, size_t len);
+  size_t print(const char* s);
+  size_t println(const char* s = "");
+  size_t printf(const char* format, ...);
+  int availableForWrite();
+  void flush();
+};
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud);
+  int available();
+  int read();
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdio.h>
+
+// Minimal checks for the host tests and benchmarks
+//
+// CHECK(cond, fmt, ...) prints "FAIL: <message>" and counts the failure
+// without stopping, so one run reports every broken expectation. main()
+// ends with `return checkResult();`.
+
+static int failures = 0;
+
+#define CHECK(cond, ...) do { if (!(cond)) { printf("FAIL: " __VA_ARGS__); printf("\n"); failures++; } } while (0)
+
+// Prints OK or FAILED (count); the process exit code
+static inline int checkResult() {
+  printf(failures ? "FAILED (%d)\n" : "OK\n", failures);
+  return failures ? 1 : 0;
+}
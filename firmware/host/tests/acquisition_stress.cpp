@@ -0,0 +1,110 @@
+// Producer/consumer stress test for AcquisitionTask (ACQ_HOST_THREAD)
+//
+// The filter runs on its own std::thread at the simulated 1 kHz ADC rate
+// while this thread reads every stream the way loop() does, stalling now
+// and then like a blocking Serial/Bluetooth print and switching the filter
+// mode and pause state under it. Checks: each stream's frames arrive in
+// capture order, version gaps account for every skipped frame, a consumer
+// that stalled gets the newest frame next, and sampling keeps going while
+// the consumer is stalled. Build with VLOVE_TSAN=ON to run it under
+// ThreadSanitizer.
+
+#include <random>
+#include <chrono>
+#include <thread>
+#include <stdio.h>
+#include "AcquisitionTask.h"
+#include "Check.h"
+
+#ifndef ACQ_HOST_THREAD
+#error "acquisition_stress needs the host thread build (ENABLE_DUAL_CORE, no ARDUINO)"
+#endif
+
+OperationMode currentMode = MODE_HOME;
+Logger logger;
+
+int main() {
+  const int runMs = 2000;
+
+  AnalogFilter filter;
+  filter.begin();
+  AcquisitionTask task(filter);
+  task.setStreams(STREAM_BIT(STREAM_FULL) | STREAM_BIT(STREAM_GESTURE) | STREAM_BIT(STREAM_HOST));
+  CHECK(task.begin(), "task did not start");
+
+  std::mt19937 rng(7);
+  uint32_t version[STREAM_COUNT] = {0};
+  uint32_t lastUs[STREAM_COUNT] = {0};
+  uint32_t frames[STREAM_COUNT] = {0};
+  uint32_t skipped[STREAM_COUNT] = {0};
+  uint32_t firstVersion[STREAM_COUNT] = {0};
+  uint32_t stalls = 0, modeSwitches = 0, pauses = 0, staleAfterStall = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(runMs)) {
+    bool any = false;
+    for (int s = 0; s < STREAM_COUNT; s++) {
+      uint32_t before = version[s];
+      FilteredFrame f;
+      if (!task.read((SampleStream)s, f, version[s])) continue;
+      any = true;
+      CHECK(f.stream == s, "stream %d: frame tagged %d", s, f.stream);
+      CHECK(version[s] > before, "stream %d: version went %u -> %u", s, before, version[s]);
+      if (frames[s] > 0) {
+        CHECK((int32_t)(f.timestampUs - lastUs[s]) > 0, "stream %d: frame at %u after %u", s,
+              f.timestampUs, lastUs[s]);
+        skipped[s] += version[s] - before - 1;
+      } else {
+        firstVersion[s] = version[s];
+      }
+      lastUs[s] = f.timestampUs;
+      frames[s]++;
+    }
+    if (!any) {
+      task.wait();
+      continue;
+    }
+
+    // A blocking print: up to 150 ms without reading
+    if (rng() % 200 == 0) {
+      uint32_t producedBefore = task.getProduced();
+      bool wasPaused = task.isPaused();
+      std::this_thread::sleep_for(std::chrono::milliseconds(rng() % 150));
+      stalls++;
+      CHECK(wasPaused || task.isPaused() || task.getProduced() > producedBefore,
+            "sampling stopped during a consumer stall");
+
+      // The next read is the newest frame, not a backlog
+      FilteredFrame f;
+      uint32_t seen = version[STREAM_FULL];
+      if (task.read(STREAM_FULL, f, seen) && task.getVersion(STREAM_FULL) > seen + 1) {
+        staleAfterStall++;
+      }
+    }
+
+    if (rng() % 500 == 0) {
+      task.setFilterMode((FilterMode)(rng() % FILTER_MODE_COUNT));
+      modeSwitches++;
+    }
+    if (rng() % 1500 == 0) {
+      task.setPaused(true);
+      std::this_thread::sleep_for(std::chrono::milliseconds(rng() % 20));
+      task.setPaused(false);
+      pauses++;
+    }
+  }
+  task.end();
+
+  for (int s = 0; s < STREAM_COUNT; s++) {
+    printf("stream %d: %u frames, %u skipped, version %u\n", s, frames[s], skipped[s], version[s]);
+    CHECK(frames[s] > 0, "stream %d: no frames", s);
+    CHECK(frames[s] + skipped[s] == version[s] - firstVersion[s] + 1, "stream %d: frames unaccounted for", s);
+  }
+  printf("produced %u, %u stalls, %u mode switches, %u pauses, engine dropped %u\n",
+         task.getProduced(), stalls, modeSwitches, pauses, filter.getAdc().getDropped());
+  CHECK(staleAfterStall <= stalls / 20, "%u of %u stalls read an old frame", staleAfterStall, stalls);
+  CHECK(task.getProduced() > (uint32_t)runMs / 4, "only %u frames produced in %d ms",
+        task.getProduced(), runMs);
+
+  return checkResult();
+}
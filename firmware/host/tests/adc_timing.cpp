@@ -0,0 +1,72 @@
+// Frame timing of the timed ADC backend on the simulated timer
+//
+// Processing takes an irregular time per pass, so simulated time is
+// advanced in uneven 0.2-3.2 ms chunks before each service(). Every frame
+// must still come out exactly one period after the previous one, with
+// nothing dropped. Then the consumer stalls for 200 ms: the ring keeps the
+// ADC_RING_SIZE frames captured first, the rest are counted as dropped,
+// and timing is exact again once the consumer is back.
+
+#include <stdio.h>
+#include "AdcEngine.h"
+#include "Check.h"
+
+int main() {
+  const uint32_t periodUs = 1000000UL / ADC_FRAME_RATE_HZ;
+
+  AdcEngine<SimulatedAdcBackend> engine;
+  uint8_t pins[ADC_ENGINE_CHANNELS] = {0};
+  bool inverted[ADC_ENGINE_CHANNELS] = {false};
+  SimulatedAdcBackend& backend = engine.getBackend();
+  backend.getSource().setLevel(1, 1000);
+  backend.getSource().setNoise(1, 5);
+  CHECK(engine.begin(pins, inverted), "engine did not start");
+
+  // Uneven processing time
+  uint32_t lastUs = 0, seed = 1;
+  int frames = 0, irregular = 0;
+  for (int pass = 0; pass < 2000; pass++) {
+    seed = seed * 1103515245u + 12345u;
+    backend.advance(200 + (seed >> 16) % 3000);
+    engine.service();
+    AdcFrame f;
+    while (engine.read(f)) {
+      if (frames++ > 0 && f.timestampUs - lastUs != periodUs) irregular++;
+      lastUs = f.timestampUs;
+    }
+  }
+  printf("uneven passes: %d frames, %d irregular intervals, dropped %u\n",
+         frames, irregular, backend.getDropped() + engine.getDropped());
+  CHECK(frames > 3000, "only %d frames", frames);
+  CHECK(irregular == 0, "%d intervals were not %u us", irregular, periodUs);
+  CHECK(backend.getDropped() == 0 && engine.getDropped() == 0, "frames dropped without a stall");
+
+  // 200 ms without service()
+  const uint32_t stallUs = 200000;
+  uint32_t stallStartUs = backend.getTimer().now();
+  backend.advance(stallUs);
+  engine.service();
+  AdcFrame f = AdcFrame();
+  int drained = 0;
+  uint32_t firstUs = 0;
+  while (engine.read(f)) {
+    if (drained++ == 0) firstUs = f.timestampUs;
+    lastUs = f.timestampUs;
+  }
+  uint32_t due = (backend.getTimer().now() - stallStartUs) / periodUs;
+  printf("after %u ms stall: %d frames kept (%u..%u us), backend dropped %u, engine dropped %u\n",
+         stallUs / 1000, drained, firstUs, lastUs, backend.getDropped(), engine.getDropped());
+  CHECK(drained == ADC_RING_SIZE, "kept %d frames, ring holds %d", drained, ADC_RING_SIZE);
+  CHECK((uint32_t)drained + backend.getDropped() >= due - 1, "%u frames due, %d kept + %u dropped",
+        due, drained, backend.getDropped());
+  CHECK(lastUs - firstUs == (uint32_t)(drained - 1) * periodUs, "kept frames are not consecutive");
+
+  // Back on time: the next frame follows the clock, not the backlog
+  backend.advance(periodUs);
+  engine.service();
+  CHECK(engine.read(f), "no frame after the stall");
+  CHECK(f.timestampUs - lastUs == (uint32_t)(backend.getDropped() + 1) * periodUs,
+        "frame after the stall at %u, last kept %u", f.timestampUs, lastUs);
+
+  return checkResult();
+}
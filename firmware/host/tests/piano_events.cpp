@@ -0,0 +1,65 @@
+// AirPiano chord events on the bus
+//
+// Chord mode: pressing fingers one after another changes the chord each
+// time. Every change must publish the old chord's NOTE_OFF before the new
+// chord's NOTE_ON, so a subscriber holding notes ends with none stuck.
+
+#include <stdio.h>
+#include <set>
+#include "AirPiano.h"
+#include "Check.h"
+
+OperationMode currentMode = MODE_PIANO_CHORD;
+
+// A synth that holds whatever the events say is sounding
+struct Held {
+  std::set<int> notes;
+  int events;
+};
+
+static void onEvent(const GloveEvent& event, void* arg) {
+  Held* held = static_cast<Held*>(arg);
+  const PianoEvent& p = event.piano;
+  held->events++;
+  for (int i = 0; i < p.chordSize; i++) {
+    if (event.type == EVENT_NOTE_ON) {
+      held->notes.insert(p.chord[i]);
+    } else if (event.type == EVENT_NOTE_OFF) {
+      CHECK(held->notes.erase(p.chord[i]) == 1, "note off for %d, which was not on", p.chord[i]);
+    }
+  }
+}
+
+static void press(AirPiano& piano, FingerFrame& frame, int finger, bool down) {
+  frame.onset[finger] = down ? 3000 : 200;
+  frame.position[finger] = frame.onset[finger];
+  frame.seq++;
+  piano.process(frame, MODE_PIANO_CHORD);
+}
+
+int main() {
+  Held held;
+  held.events = 0;
+  EventBus bus;
+  bus.subscribe(onEvent, &held, EVENTS_PIANO);
+  AirPiano piano;
+  piano.setEventBus(&bus);
+
+  FingerFrame frame = {};
+  for (int i = 0; i < FINGER_COUNT; i++) press(piano, frame, i, false);
+
+  press(piano, frame, 1, true);
+  CHECK(held.notes.size() == 1, "1 finger: %u notes held", (unsigned)held.notes.size());
+  press(piano, frame, 2, true);
+  CHECK(held.notes.size() == 2, "2 fingers: %u notes held", (unsigned)held.notes.size());
+  press(piano, frame, 3, true);
+  CHECK(held.notes.size() == 3, "3 fingers: %u notes held", (unsigned)held.notes.size());
+  press(piano, frame, 1, false);
+  CHECK(held.notes.size() == 2 && !held.notes.count(NOTE_INDEX), "index released: %u notes held",
+        (unsigned)held.notes.size());
+  for (int i = 0; i < FINGER_COUNT; i++) press(piano, frame, i, false);
+  CHECK(held.notes.empty(), "%u notes stuck after release", (unsigned)held.notes.size());
+
+  printf("%d events\n", held.events);
+  return checkResult();
+}
@@ -0,0 +1,70 @@
+// PositionMap against the map() / constrain() path it replaced
+//
+// For calibrated ranges from the narrowest accepted one to the full scale,
+// every filtered value must land within 1 count of the exact, rounded
+// position and of Arduino map(); the 0-255 scale must equal
+// position * 255 / ANALOG_MAX, and mapFrame() the per-channel calls.
+
+#include <stdio.h>
+#include <math.h>
+#include "PositionMap.h"
+#include "Check.h"
+
+static void checkRange(PositionMap& positions, int lo, int hi) {
+  positions.build(0, lo, hi);
+  bool valid = hi > lo;
+  int worst = 0;
+  for (int v = -100; v <= ANALOG_MAX + 100; v++) {
+    int p = positions.map(0, v);
+    double exact = valid ? (double)(v - lo) * ANALOG_MAX / (hi - lo) : v;
+    int rounded = constrain((int)floor(exact + 0.5), 0, ANALOG_MAX);
+    int arduino = valid ? constrain((int)map(v, lo, hi, 0, ANALOG_MAX), 0, ANALOG_MAX)
+                        : constrain(v, 0, ANALOG_MAX);
+    int err = abs(p - rounded);
+    if (err > worst) worst = err;
+    CHECK(err <= 1 && abs(p - arduino) <= 1,
+          "range %d-%d: %d -> %d, exact %d, map() %d", lo, hi, v, p, rounded, arduino);
+  }
+  printf("range %4d-%4d  worst %d count(s) from exact\n", lo, hi, worst);
+}
+
+int main() {
+  PositionMap positions;
+
+  checkRange(positions, 0, ANALOG_MAX);        // Uncalibrated
+  checkRange(positions, 1200, 1700);           // Narrowest range CAL accepts
+  checkRange(positions, 1500, 2300);
+  checkRange(positions, 300, 3800);
+  checkRange(positions, 1, 4094);
+  checkRange(positions, 2000, 2000);           // Empty: passes through
+  checkRange(positions, 2500, 1000);
+
+  // 0-255 scale: the Q16 multiply must match the divide for every position
+  positions.build(0, 0, ANALOG_MAX);
+  for (int v = 0; v <= ANALOG_MAX; v++) {
+    int p = positions.map(0, v);
+    CHECK(positions.normalize(0, v) == p * 255 / ANALOG_MAX,
+          "normalize(%d) = %d, want %d", v, positions.normalize(0, v), p * 255 / ANALOG_MAX);
+  }
+
+  // Whole frames, each channel with its own range
+  for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+    positions.build(ch, 200 + ch * 100, 3000 + ch * 150);
+  }
+  int value[SENSOR_COUNT];
+  int16_t pos[SENSOR_COUNT];
+  uint8_t norm[SENSOR_COUNT];
+  for (int v = 0; v <= ANALOG_MAX; v += 7) {
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      value[ch] = (v + ch * 613) % (ANALOG_MAX + 1);
+    }
+    positions.mapFrame(value, pos, norm);
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      CHECK(pos[ch] == positions.map(ch, value[ch]) && norm[ch] == positions.normalize(ch, value[ch]),
+            "mapFrame channel %d differs at %d", ch, value[ch]);
+    }
+  }
+
+  printf("%zu bytes of mapping state for %d channels\n", sizeof(PositionMap), SENSOR_COUNT);
+  return checkResult();
+}
@@ -0,0 +1,330 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include "Config.h"
+#include "AnalogFilter.h"
+#include "Seqlock.h"
+#include "Profiler.h"
+#include "filter/Decimator.h"
+
+#if defined(ENABLE_DUAL_CORE) && !defined(ESP32)
+#ifdef ARDUINO
+#undef ENABLE_DUAL_CORE          // Single-core boards: filter inline in loop()
+#else
+#include <thread>
+#include <chrono>
+#define ACQ_HOST_THREAD          // Host build: std::thread stands in for the task
+#endif
+#endif
+
+// Acquisition + filtering task
+//
+// With ENABLE_DUAL_CORE the ADC engine and AnalogFilter run in their own
+// task pinned to ACQ_TASK_CORE, and loop() (the consumers: gestures, piano,
+// Serial/Bluetooth output) runs on the other core. A blocking print can
+// delay the consumers but never the sampling or filtering.
+//
+// Without it, wait() runs the filter inline on the caller's thread, so the
+// sketch looks the same either way.
+//
+// Frames are published as latest-value snapshots, one per SampleStream
+// (see Seqlock.h). The filter runs once, at the fastest stream any consumer
+// asked for (setStreams()); slower requested streams are CIC-decimated from
+// its output. Any number of consumers can then read any stream at their
+// own pace, without locks, queues or allocation. A consumer that falls
+// behind simply gets the newest frame; version gaps show what it skipped.
+//
+// Cross-core rules: only the task touches AnalogFilter after begin(). The
+// consumer side changes it through setStreams()/setFilterMode()/setTuning()/
+// setPaused(), which the task applies between frames. Read-only status (noise, tuning) may be
+// printed from loop(); a value can be one frame stale.
+
+// ============ CONFIG ============
+#define ACQ_TASK_CORE       0      // loop() runs on core 1 (ARDUINO_RUNNING_CORE)
+#define ACQ_TASK_PRIORITY   3      // Above loop() (1), below the esp_timer task
+#define ACQ_TASK_STACK      4096
+#define ACQ_PAUSED_POLL_MS  100    // Task check interval while sampling is paused
+
+// One filtered sample, as handed to the consumers
+struct FilteredFrame {
+  uint32_t timestampUs;    // Capture time
+  uint16_t intervalMs;     // Capture time since the previous frame of this stream
+  uint8_t stream;          // SampleStream it was published on
+  int value[SENSOR_COUNT]; // Smooth path (0-ANALOG_MAX, not yet calibrated)
+  int onset[SENSOR_COUNT]; // Fast onset path (newest frame)
+};
+
+#define STREAM_BIT(s)  (1u << (s))
+
+class AcquisitionTask {
+private:
+  AnalogFilter& filter;
+  Seqlock<FilteredFrame> snapshot[STREAM_COUNT];
+  std::atomic<uint8_t> requested;    // STREAM_BIT mask the consumers want
+  std::atomic<int8_t> pendingMode;   // FilterMode to apply, -1 = none
+  FilterMode requestedMode;          // Consumer side: last mode asked for
+  Seqlock<FilterTuning> tuning;      // Written by the consumer side
+  std::atomic<bool> pauseRequested;
+  std::atomic<bool> running;
+  std::atomic<uint32_t> produced;
+
+  // Task side only
+  uint8_t streams;                   // Mask currently configured
+  SampleStream base;                 // Stream the filter runs at
+  std::atomic<bool> paused;          // Applied state of pauseRequested
+  uint32_t tuningSeen;               // tuning version applied
+  CicDecimator<SENSOR_COUNT, DECIMATOR_ORDER> decimator[STREAM_COUNT];
+  uint32_t lastPublishUs[STREAM_COUNT];
+
+#if defined(ENABLE_DUAL_CORE) && defined(ESP32)
+  TaskHandle_t taskHandle;
+  TaskHandle_t consumerHandle;
+#elif defined(ACQ_HOST_THREAD)
+  std::thread worker;
+#endif
+
+  // Filter at the fastest requested stream; derive the others from it
+  void configure(uint8_t mask) {
+    streams = mask;
+    base = fastestStream(mask);
+    uint16_t baseRate = filter.getRate(base);
+    for (int s = 0; s < STREAM_COUNT; s++) {
+      uint16_t rate = filter.getRate((SampleStream)s);
+      decimator[s].setRatio(rate >= baseRate ? 1 : baseRate / rate);
+    }
+  }
+
+  void publish(SampleStream s, FilteredFrame& frame) {
+    uint32_t ms = (frame.timestampUs - lastPublishUs[s] + 500) / 1000;
+    frame.intervalMs = ms > 0xFFFF ? 0xFFFF : (uint16_t)ms;
+    frame.stream = (uint8_t)s;
+    lastPublishUs[s] = frame.timestampUs;
+    snapshot[s].write(frame);
+  }
+
+  void applyPause() {
+    bool pause = pauseRequested.load(std::memory_order_relaxed);
+    if (pause == paused.load(std::memory_order_relaxed)) return;
+    if (pause) {
+      filter.pause();
+    } else {
+      filter.resume();
+    }
+    paused.store(pause);
+  }
+
+  // Filter one frame; false if none is due
+  bool produce() {
+    int8_t mode = pendingMode.exchange(-1);
+    if (mode >= 0) filter.setMode((FilterMode)mode);
+
+    FilterTuning t;
+    if (tuning.readIfNewer(t, tuningSeen)) {
+      filter.setTuning(t);
+      configure(requested.load(std::memory_order_relaxed));  // Rates may have changed
+    }
+
+    applyPause();
+    if (paused) return false;
+
+    uint8_t mask = requested.load(std::memory_order_relaxed);
+    if (mask != streams) configure(mask);
+
+    FilteredFrame frame;
+    PROFILE_START(filterStart);
+    if (!filter.readFiltered(frame.value, base)) return false;
+    frame.timestampUs = filter.getLastTimestampUs();
+    filter.readOnset(frame.onset);
+    PROFILE_STOP(filterStart, PROF_FILTER);
+    PROFILE_SCOPE(PROF_PUBLISH);
+
+    uint16_t in[SENSOR_COUNT];
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      in[i] = (uint16_t)frame.value[i];
+    }
+
+    for (int s = 0; s < STREAM_COUNT; s++) {
+      if (s == base || !(streams & STREAM_BIT(s))) continue;
+      if (decimator[s].getRatio() == 1) {
+        FilteredFrame copy = frame;
+        publish((SampleStream)s, copy);
+        continue;
+      }
+      FilteredFrame slow = frame;
+      if (decimator[s].push(in, slow.value)) publish((SampleStream)s, slow);
+    }
+    publish(base, frame);
+    produced++;
+    return true;
+  }
+
+#ifdef ENABLE_DUAL_CORE
+  // Filter everything due, wake the consumers, sleep a tick
+  void run() {
+    while (running.load()) {
+      bool any = false;
+#ifdef ENABLE_ADC_ENGINE
+      while (produce()) any = true;
+#else
+      any = produce();
+#endif
+      if (any) notifyConsumer();
+      idle();
+    }
+  }
+
+  static void taskMain(void* arg) {
+    static_cast<AcquisitionTask*>(arg)->run();
+#if defined(ESP32)
+    vTaskDelete(nullptr);
+#endif
+  }
+#endif
+
+#if defined(ENABLE_DUAL_CORE) && defined(ESP32)
+  void notifyConsumer() {
+    if (consumerHandle) xTaskNotifyGive(consumerHandle);
+  }
+
+  void idle() {
+    if (paused) {
+      ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(ACQ_PAUSED_POLL_MS));  // setPaused(false) wakes it
+      return;
+    }
+#ifdef ENABLE_ADC_ENGINE
+    vTaskDelay(1);
+#else
+    vTaskDelay(pdMS_TO_TICKS(LOOP_DELAY_MS));
+#endif
+  }
+#elif defined(ACQ_HOST_THREAD)
+  void notifyConsumer() {}
+
+  // Host: the simulated ADC clock follows real time
+  void idle() {
+    static const uint32_t TICK_US = 1000;
+#ifdef ENABLE_ADC_ENGINE
+    filter.getAdc().getBackend().advance(TICK_US);
+#endif
+    std::this_thread::sleep_for(std::chrono::microseconds(TICK_US));
+  }
+#endif
+
+public:
+  explicit AcquisitionTask(AnalogFilter& analogFilter)
+    : filter(analogFilter), requested(STREAM_BIT(STREAM_GESTURE)), pendingMode(-1),
+      requestedMode(analogFilter.getMode()),
+      pauseRequested(false), running(false), produced(0), streams(0), base(STREAM_GESTURE),
+      paused(false), tuningSeen(0)
+#if defined(ENABLE_DUAL_CORE) && defined(ESP32)
+    , taskHandle(nullptr), consumerHandle(nullptr)
+#endif
+  {
+    for (int s = 0; s < STREAM_COUNT; s++) {
+      lastPublishUs[s] = 0;
+    }
+  }
+
+  // Call from setup() after analogFilter.begin(); the caller becomes the consumer
+  bool begin() {
+    configure(requested.load());
+    running = true;
+#if defined(ENABLE_DUAL_CORE) && defined(ESP32)
+    consumerHandle = xTaskGetCurrentTaskHandle();
+    BaseType_t ok = xTaskCreatePinnedToCore(&AcquisitionTask::taskMain, "acquire", ACQ_TASK_STACK,
+                                            this, ACQ_TASK_PRIORITY, &taskHandle, ACQ_TASK_CORE);
+    running = (ok == pdPASS);
+#elif defined(ACQ_HOST_THREAD)
+    worker = std::thread(&AcquisitionTask::taskMain, this);
+#endif
+    return running;
+  }
+
+  // Stop the task (host tests); the firmware never stops it
+  void end() {
+    running = false;
+#if defined(ACQ_HOST_THREAD)
+    if (worker.joinable()) worker.join();
+#endif
+  }
+
+  // Consumer side: newest frame of a stream, if published since `version`
+  // (each consumer keeps its own version, starting at 0)
+  bool read(SampleStream s, FilteredFrame& frame, uint32_t& version) const {
+    return snapshot[s].readIfNewer(frame, version);
+  }
+
+  // Publish count of a stream, to spot skipped frames
+  uint32_t getVersion(SampleStream s) const { return snapshot[s].version(); }
+
+  // Nothing new for any consumer: block until the next frame (dual-core,
+  // up to timeoutMs) or filter the next one inline
+  void wait(uint32_t timeoutMs = 1) {
+#if defined(ENABLE_DUAL_CORE) && defined(ESP32)
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+#elif defined(ENABLE_DUAL_CORE)
+    (void)timeoutMs;
+    std::this_thread::sleep_for(std::chrono::microseconds(100));  // Host: short poll
+#else
+    (void)timeoutMs;
+#ifdef ENABLE_ADC_ENGINE
+    while (produce()) {}
+#else
+    delay(LOOP_DELAY_MS);
+    produce();
+#endif
+#endif
+  }
+
+  // Streams the consumers read (STREAM_BIT mask); applied from the next frame
+  void setStreams(uint8_t mask) {
+    if (mask == 0) mask = STREAM_BIT(STREAM_GESTURE);
+    requested.store(mask, std::memory_order_relaxed);
+  }
+
+  // Requested stream with the highest rate
+  SampleStream fastestStream(uint8_t mask) const {
+    SampleStream best = STREAM_GESTURE;
+    uint16_t bestRate = 0;
+    for (int s = 0; s < STREAM_COUNT; s++) {
+      if (!(mask & STREAM_BIT(s))) continue;
+      uint16_t rate = filter.getRate((SampleStream)s);
+      if (rate > bestRate) {
+        best = (SampleStream)s;
+        bestRate = rate;
+      }
+    }
+    return best;
+  }
+
+  // Stop / restart sampling and filtering (power saving). Restarting is
+  // immediate: the first frame follows one ADC period later.
+  void setPaused(bool pause) {
+    if (pauseRequested.exchange(pause) == pause) return;
+#if defined(ENABLE_DUAL_CORE) && defined(ESP32)
+    if (!pause && taskHandle) xTaskNotifyGive(taskHandle);
+#elif !defined(ENABLE_DUAL_CORE)
+    applyPause();   // Inline: this is the filter's thread
+#endif
+  }
+
+  // True once the task has actually stopped sampling (ADC pins are free)
+  bool isPaused() const { return paused.load(); }
+
+  // Switch the filter mode from the consumer side; the task applies it
+  // before its next frame
+  void setFilterMode(FilterMode mode) {
+    requestedMode = mode;
+    pendingMode.store((int8_t)mode);
+  }
+
+  // Mode last requested (already in effect or about to be); read this on
+  // the consumer side rather than AnalogFilter::getMode()
+  FilterMode getFilterMode() const { return requestedMode; }
+
+  // Change filter constants / stream rates from the consumer side
+  void setTuning(const FilterTuning& t) { tuning.write(t); }
+
+  uint32_t getProduced() const { return produced; }
+};
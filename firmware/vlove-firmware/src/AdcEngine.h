@@ -0,0 +1,483 @@
+#pragma once
+
+#include <stdint.h>
+#ifdef ARDUINO
+#include <Arduino.h>
+#endif
+#include "SpscRing.h"
+#include "FrameTimer.h"
+
+// Multi-channel ADC acquisition engine
+//
+// Samples all finger channels together into timestamped frames and queues
+// them in a lock-free ring, so the sketch no longer does 20 back-to-back
+// blocking analogRead() calls with the fingers read at skewed instants.
+//
+// Backends:
+//   ContinuousAdcBackend - ESP32 continuous (DMA) ADC mode, Arduino-ESP32 3.x.
+//                          The hardware scans all pins round-robin; the CPU
+//                          only collects finished frames.
+//   TimedAdcBackend      - a periodic timer (esp_timer on ESP32) reads every
+//                          channel with analogRead() at an exact rate, for
+//                          older cores. Frame timing is independent of loop().
+//   PolledAdcBackend     - analogRead() when service() finds a frame due, for
+//                          non-ESP32 boards.
+//   SimulatedAdcBackend  - TimedAdcBackend on a simulated timer with a
+//                          synthetic signal + noise, for host builds.
+//
+// Oversampling adapts per channel: the engine tracks each channel's noise
+// (second-difference variance, which ignores steady finger motion) and picks
+// the smallest power-of-two average that brings it under ADC_NOISE_TARGET.
+// Clean channels stay at 1x and add no delay.
+
+#ifndef ANALOG_MAX
+#define ANALOG_MAX 4095
+#endif
+
+// ============ CONFIG ============
+#ifdef SENSOR_COUNT
+#define ADC_ENGINE_CHANNELS   SENSOR_COUNT   // Every channel of the frame (Config.h)
+#else
+#define ADC_ENGINE_CHANNELS   5
+#endif
+#define ADC_FRAME_RATE_HZ     1000   // Frames per second (every channel once per frame)
+#define ADC_CONVERSIONS       4      // Hardware conversions averaged per pin per frame (continuous mode)
+#define ADC_RING_SIZE         64     // Frames buffered between service() and the consumer
+#define ADC_MAX_OVERSAMPLE    8      // Upper bound for adaptive oversampling (power of two)
+#define ADC_NOISE_TARGET      4      // Target output noise variance (counts^2)
+#define ADC_ADAPT_INTERVAL    256    // Frames between oversampling updates
+
+// One acquisition instant for all channels
+struct AdcFrame {
+  uint32_t timestampUs;                    // Capture time (micros)
+  uint16_t value[ADC_ENGINE_CHANNELS];     // Inverted where configured, 0-ANALOG_MAX
+};
+
+// ============ BACKENDS ============
+// A backend provides:
+//   bool begin(const uint8_t* pins, uint8_t count, uint32_t frameRateHz,
+//              const uint8_t* oversample)
+//     -> oversample points at the engine's live per-channel factors
+//   bool read(int* values, uint32_t* timestampUs)
+//     -> one frame if available; values are raw (not inverted)
+//   void stop()
+//     -> stop sampling; begin() starts it again
+//   static const bool OVERSAMPLES_INTERNALLY
+//     -> true if the backend itself averages oversample[ch] conversions,
+//        false if the engine should average over consecutive frames instead
+
+#if defined(ESP32) && defined(ESP_ARDUINO_VERSION_MAJOR) && ESP_ARDUINO_VERSION_MAJOR >= 3
+#define ADC_HAS_CONTINUOUS 1
+
+// Set from the conversion-done ISR
+static volatile bool adcFrameReady = false;
+static volatile uint32_t adcFrameUs = 0;
+
+static void ARDUINO_ISR_ATTR onAdcFrame() {
+  adcFrameUs = micros();
+  adcFrameReady = true;
+}
+
+class ContinuousAdcBackend {
+private:
+  uint8_t channelCount;
+
+public:
+  static const bool OVERSAMPLES_INTERNALLY = false;
+
+  ContinuousAdcBackend() : channelCount(0) {}
+
+  bool begin(const uint8_t* pins, uint8_t count, uint32_t frameRateHz, const uint8_t*) {
+    channelCount = count;
+    analogContinuousSetWidth(12);
+    analogContinuousSetAtten(ADC_11db);
+
+    // Total conversion rate across all pins
+    uint32_t sampleRate = frameRateHz * count * ADC_CONVERSIONS;
+    if (!analogContinuous((uint8_t*)pins, count, ADC_CONVERSIONS, sampleRate, &onAdcFrame)) {
+      return false;
+    }
+    return analogContinuousStart();
+  }
+
+  // Release the pins so analogRead() works while stopped
+  void stop() {
+    analogContinuousStop();
+    analogContinuousDeinit();
+    adcFrameReady = false;
+  }
+
+  bool read(int* values, uint32_t* timestampUs) {
+    if (!adcFrameReady) return false;
+    adcFrameReady = false;
+
+    adc_continuous_data_t* result = nullptr;
+    if (!analogContinuousRead(&result, 0)) return false;
+
+    for (uint8_t i = 0; i < channelCount; i++) {
+      values[i] = result[i].avg_read_raw;
+    }
+    *timestampUs = adcFrameUs;
+    return true;
+  }
+};
+#endif
+
+// ============ SAMPLE SOURCES ============
+// What the timed and polled backends read for one frame:
+//   void begin(const uint8_t* pins, uint8_t count)
+//   void read(int* values, const uint8_t* oversample)
+//     -> raw (not inverted), each channel averaged over oversample[ch]
+
+#ifdef ARDUINO
+class AnalogReadSource {
+private:
+  const uint8_t* pins;
+  uint8_t channelCount;
+
+public:
+  AnalogReadSource() : pins(nullptr), channelCount(0) {}
+
+  void begin(const uint8_t* pinList, uint8_t count) {
+    pins = pinList;
+    channelCount = count;
+  }
+
+  // Round r reads every channel that still needs a conversion, so all
+  // channels are sampled close together instead of pin after pin
+  void read(int* values, const uint8_t* oversample) {
+    uint8_t rounds = 1;
+    for (uint8_t i = 0; i < channelCount; i++) {
+      values[i] = 0;
+      if (oversample[i] > rounds) rounds = oversample[i];
+    }
+
+    for (uint8_t r = 0; r < rounds; r++) {
+      for (uint8_t i = 0; i < channelCount; i++) {
+        if (r < oversample[i]) values[i] += analogRead(pins[i]);
+      }
+    }
+    for (uint8_t i = 0; i < channelCount; i++) {
+      values[i] /= oversample[i];
+    }
+  }
+};
+#endif
+
+// Synthetic signal: per-channel level plus Gaussian-ish noise, so host
+// builds run the real engine and filters on repeatable data
+class SyntheticSource {
+private:
+  uint8_t channelCount;
+  uint32_t seed;
+  int level[ADC_ENGINE_CHANNELS];
+  int noise[ADC_ENGINE_CHANNELS];    // Approximate std-dev in counts
+
+  // Sum of four uniforms: cheap bell curve, std-dev ~1 for unit scale
+  int gaussian(int sigma) {
+    int32_t sum = 0;
+    for (int i = 0; i < 4; i++) {
+      seed = seed * 1664525u + 1013904223u;
+      sum += (int32_t)(seed >> 20) - 2048;
+    }
+    return (int)((sum * (int32_t)sigma) / 2365);
+  }
+
+public:
+  SyntheticSource() : channelCount(0), seed(12345) {
+    for (int i = 0; i < ADC_ENGINE_CHANNELS; i++) {
+      level[i] = ANALOG_MAX / 2;
+      noise[i] = 0;
+    }
+  }
+
+  void begin(const uint8_t*, uint8_t count) { channelCount = count; }
+
+  void setLevel(uint8_t ch, int value) { level[ch] = value; }
+  void setNoise(uint8_t ch, int sigma) { noise[ch] = sigma; }
+
+  void read(int* values, const uint8_t* oversample) {
+    for (uint8_t i = 0; i < channelCount; i++) {
+      int32_t sum = 0;
+      for (uint8_t r = 0; r < oversample[i]; r++) {
+        int v = level[i] + gaussian(noise[i]);
+        sum += v < 0 ? 0 : (v > ANALOG_MAX ? ANALOG_MAX : v);
+      }
+      values[i] = sum / oversample[i];
+    }
+  }
+};
+
+// ============ TIMED / POLLED BACKENDS ============
+
+// Frames captured on a periodic timer (see FrameTimer.h) into a lock-free
+// ring. Capture instants are fixed by the timer, not by loop(), so frame
+// timing stays exact however long processing takes; if the consumer falls
+// behind, frames are dropped and counted rather than delayed.
+template <class Timer, class Source>
+class TimedAdcBackend {
+private:
+  Timer timer;
+  Source source;
+  SpscRing<AdcFrame, ADC_RING_SIZE> ring;
+  const uint8_t* oversample;
+  uint8_t channelCount;
+
+  static void onTick(void* arg) {
+    static_cast<TimedAdcBackend*>(arg)->capture();
+  }
+
+  // Timer context: read one frame, stamp it with the middle of the burst
+  void capture() {
+    int values[ADC_ENGINE_CHANNELS];
+    uint32_t start = timer.now();
+    source.read(values, oversample);
+
+    AdcFrame frame;
+    frame.timestampUs = start + (timer.now() - start) / 2;
+    for (uint8_t i = 0; i < channelCount; i++) {
+      frame.value[i] = (uint16_t)values[i];
+    }
+    ring.push(frame);
+  }
+
+public:
+  static const bool OVERSAMPLES_INTERNALLY = true;
+
+  TimedAdcBackend() : oversample(nullptr), channelCount(0) {}
+
+  bool begin(const uint8_t* pins, uint8_t count, uint32_t frameRateHz, const uint8_t* oversampleFactors) {
+    channelCount = count;
+    oversample = oversampleFactors;
+    source.begin(pins, count);
+    return timer.begin(1000000UL / frameRateHz, &onTick, this);
+  }
+
+  void stop() { timer.stop(); }
+
+  bool read(int* values, uint32_t* timestampUs) {
+    AdcFrame frame;
+    if (!ring.pop(frame)) return false;
+    for (uint8_t i = 0; i < channelCount; i++) {
+      values[i] = frame.value[i];
+    }
+    *timestampUs = frame.timestampUs;
+    return true;
+  }
+
+  // Frames lost because the consumer didn't drain the ring in time
+  uint32_t getDropped() const { return ring.getDropped(); }
+
+  Timer& getTimer() { return timer; }
+  Source& getSource() { return source; }
+
+  // Simulated timer only: let time run forward
+  void advance(uint32_t us) { timer.advance(us); }
+};
+
+#ifdef ARDUINO
+// Fallback without a periodic timer: reads a frame when service() is
+// called and one is due. Timing depends on how often loop() gets there.
+class PolledAdcBackend {
+private:
+  AnalogReadSource source;
+  const uint8_t* oversample;
+  uint32_t periodUs;
+  uint32_t nextUs;
+
+public:
+  static const bool OVERSAMPLES_INTERNALLY = true;
+
+  PolledAdcBackend() : oversample(nullptr), periodUs(1000), nextUs(0) {}
+
+  bool begin(const uint8_t* pins, uint8_t count, uint32_t frameRateHz, const uint8_t* oversampleFactors) {
+    source.begin(pins, count);
+    oversample = oversampleFactors;
+    periodUs = 1000000UL / frameRateHz;
+    nextUs = micros();
+    return true;
+  }
+
+  void stop() {}   // Nothing runs between reads
+
+  // After a long stall it resyncs instead of bursting to catch up
+  bool read(int* values, uint32_t* timestampUs) {
+    uint32_t now = micros();
+    if ((int32_t)(now - nextUs) < 0) return false;
+    nextUs = (now - nextUs >= periodUs) ? now + periodUs : nextUs + periodUs;
+
+    source.read(values, oversample);
+    *timestampUs = now + (micros() - now) / 2;  // Middle of the burst
+    return true;
+  }
+};
+#endif
+
+// Host builds: the real engine on a simulated clock and synthetic signal
+typedef TimedAdcBackend<SimulatedFrameTimer, SyntheticSource> SimulatedAdcBackend;
+
+// ============ ENGINE ============
+
+template <class Backend>
+class AdcEngine {
+private:
+  Backend backend;
+  SpscRing<AdcFrame, ADC_RING_SIZE> ring;
+  bool running;
+
+  uint8_t pins[ADC_ENGINE_CHANNELS];
+  bool inverted[ADC_ENGINE_CHANNELS];
+
+  // Adaptive oversampling
+  uint8_t oversample[ADC_ENGINE_CHANNELS];             // Current factor (1..ADC_MAX_OVERSAMPLE)
+  uint16_t history[ADC_ENGINE_CHANNELS][ADC_MAX_OVERSAMPLE];  // Recent frames for frame averaging
+  uint8_t historyIndex;
+
+  // Noise estimate: EMA of squared second difference, 8 fractional bits
+  int prev1[ADC_ENGINE_CHANNELS];
+  int prev2[ADC_ENGINE_CHANNELS];
+  uint32_t noiseQ8[ADC_ENGINE_CHANNELS];
+  uint16_t adaptCounter;
+  uint32_t frameCount;
+
+  void updateNoise(uint8_t ch, int x) {
+    int d2 = x - 2 * prev1[ch] + prev2[ch];
+    prev2[ch] = prev1[ch];
+    prev1[ch] = x;
+    if (frameCount < 2) return;
+
+    // Clamp so a single spike cannot overflow or dominate the estimate
+    if (d2 > 1000) d2 = 1000;
+    if (d2 < -1000) d2 = -1000;
+
+    uint32_t sq = (uint32_t)(d2 * d2) << 8;
+    if (sq > noiseQ8[ch]) {
+      noiseQ8[ch] += (sq - noiseQ8[ch]) >> 5;
+    } else {
+      noiseQ8[ch] -= (noiseQ8[ch] - sq) >> 5;
+    }
+  }
+
+  // Second-difference variance of white noise is 6 sigma^2; with internal
+  // oversampling the measured variance is already divided by the factor
+  void adapt() {
+    for (uint8_t ch = 0; ch < ADC_ENGINE_CHANNELS; ch++) {
+      uint32_t variance = noiseQ8[ch] / (6 << 8);
+      if (Backend::OVERSAMPLES_INTERNALLY) variance *= oversample[ch];
+
+      uint8_t factor = 1;
+      while (factor < ADC_MAX_OVERSAMPLE && variance / factor > ADC_NOISE_TARGET) {
+        factor <<= 1;
+      }
+      oversample[ch] = factor;
+    }
+  }
+
+public:
+  AdcEngine() : running(false), historyIndex(0), adaptCounter(0), frameCount(0) {
+    for (uint8_t ch = 0; ch < ADC_ENGINE_CHANNELS; ch++) {
+      pins[ch] = 0;
+      inverted[ch] = false;
+      oversample[ch] = 1;
+      prev1[ch] = 0;
+      prev2[ch] = 0;
+      noiseQ8[ch] = 0;
+      for (uint8_t j = 0; j < ADC_MAX_OVERSAMPLE; j++) {
+        history[ch][j] = 0;
+      }
+    }
+  }
+
+  bool begin(const uint8_t* pinList, const bool* invert) {
+    for (uint8_t ch = 0; ch < ADC_ENGINE_CHANNELS; ch++) {
+      pins[ch] = pinList[ch];
+      inverted[ch] = invert[ch];
+    }
+    running = backend.begin(pins, ADC_ENGINE_CHANNELS, ADC_FRAME_RATE_HZ, oversample);
+    return running;
+  }
+
+  // Stop sampling to save power; frames already queued are dropped
+  void pause() {
+    if (!running) return;
+    backend.stop();
+    running = false;
+  }
+
+  // Start sampling again after pause(); the next frame is one period away
+  bool resume() {
+    if (running) return true;
+    int raw[ADC_ENGINE_CHANNELS];
+    uint32_t timestampUs;
+    while (backend.read(raw, &timestampUs)) {}
+    AdcFrame stale;
+    while (ring.pop(stale)) {}
+    running = backend.begin(pins, ADC_ENGINE_CHANNELS, ADC_FRAME_RATE_HZ, oversample);
+    return running;
+  }
+
+  // Move finished conversions into the frame ring; call often
+  void service() {
+    if (!running) return;
+
+    int raw[ADC_ENGINE_CHANNELS];
+    uint32_t timestampUs;
+    while (backend.read(raw, &timestampUs)) {
+      AdcFrame frame;
+      frame.timestampUs = timestampUs;
+      historyIndex = (historyIndex + 1) & (ADC_MAX_OVERSAMPLE - 1);
+
+      for (uint8_t ch = 0; ch < ADC_ENGINE_CHANNELS; ch++) {
+        updateNoise(ch, raw[ch]);
+        int value = raw[ch];
+
+        // Average the last oversample[ch] frames
+        if (!Backend::OVERSAMPLES_INTERNALLY) {
+          history[ch][historyIndex] = value;
+          int32_t sum = 0;
+          for (uint8_t k = 0; k < oversample[ch]; k++) {
+            sum += history[ch][(historyIndex - k) & (ADC_MAX_OVERSAMPLE - 1)];
+          }
+          value = sum / oversample[ch];
+        }
+
+        frame.value[ch] = inverted[ch] ? ANALOG_MAX - value : value;
+      }
+
+      frameCount++;
+      if (++adaptCounter >= ADC_ADAPT_INTERVAL) {
+        adaptCounter = 0;
+        adapt();
+      }
+
+      ring.push(frame);
+    }
+  }
+
+  // Oldest queued frame
+  bool read(AdcFrame& frame) { return ring.pop(frame); }
+
+  // Newest frame, discarding older ones
+  bool readLatest(AdcFrame& frame) { return ring.popLatest(frame); }
+
+  uint32_t pending() const { return ring.available(); }
+  uint32_t getDropped() const { return ring.getDropped(); }
+  uint32_t getFrameCount() const { return frameCount; }
+  uint8_t getOversample(uint8_t ch) const { return oversample[ch]; }
+  bool isRunning() const { return running; }
+
+  // Estimated per-conversion noise variance (counts^2)
+  uint32_t getNoiseVariance(uint8_t ch) const { return noiseQ8[ch] / (6 << 8); }
+
+  Backend& getBackend() { return backend; }
+};
+
+#if defined(ADC_HAS_CONTINUOUS)
+typedef AdcEngine<ContinuousAdcBackend> AcquisitionEngine;
+#elif defined(ESP32)
+typedef AdcEngine<TimedAdcBackend<EspFrameTimer, AnalogReadSource> > AcquisitionEngine;
+#elif defined(ARDUINO)
+typedef AdcEngine<PolledAdcBackend> AcquisitionEngine;
+#else
+typedef AdcEngine<SimulatedAdcBackend> AcquisitionEngine;
+#endif
@@ -1,32 +1,98 @@
 #pragma once
 
 #include "Config.h"
+#include "FingerFeatures.h"
+#include "FingerFrame.h"
+#include "Events.h"
+
+// Note hysteresis on the calibrated onset value (defaults, see setThresholds)
+#define PIANO_ON_THRESHOLD   1500      // Above this = note on
+#define PIANO_OFF_THRESHOLD  1000      // Below this = note off
+
+// Strike velocity from curl speed (needs setFeatures)
+#define PIANO_FULL_SPEED     30000.0f  // counts/s that give velocity 127 (~full curl in 140 ms)
+#define PIANO_MIN_VELOCITY   20        // Slowest press
 
 class AirPiano {
 private:
   // Base MIDI notes for each finger
-  const uint8_t baseNotes[5] = {NOTE_THUMB, NOTE_INDEX, NOTE_MIDDLE, NOTE_RING, NOTE_PINKY};
+  const uint8_t baseNotes[FINGER_COUNT] = {NOTE_THUMB, NOTE_INDEX, NOTE_MIDDLE, NOTE_RING, NOTE_PINKY};
 
   // Chord definitions (MIDI note offsets from root)
   // Major chord: root, major 3rd (+4), perfect 5th (+7)
   // Minor chord: root, minor 3rd (+3), perfect 5th (+7)
 
   // Track finger states for note on/off
-  bool fingerActive[5] = {false, false, false, false, false};
+  bool fingerActive[FINGER_COUNT] = {};
 
   // Threshold for triggering a note (high value = finger bent = note on)
-  const int NOTE_ON_THRESHOLD = 1500;   // Above this = note on
-  const int NOTE_OFF_THRESHOLD = 1000;  // Below this = note off
+  int noteOnThreshold = PIANO_ON_THRESHOLD;
+  int noteOffThreshold = PIANO_OFF_THRESHOLD;
+
+  // Strike velocity curve
+  float fullSpeed = PIANO_FULL_SPEED;
+  uint8_t minVelocity = PIANO_MIN_VELOCITY;
 
   // For pitch bend mode
   int lastPitchBend = 0;
 
   // For chord mode
-  uint8_t lastChord[5] = {0, 0, 0, 0, 0};
+  uint8_t lastChord[FINGER_COUNT] = {};
   uint8_t lastChordSize = 0;
 
+  // Shared finger motion features (optional)
+  const FingerFeatures* features = nullptr;
+
+  // Where note events go (optional)
+  EventBus* events = nullptr;
+
+  // Hysteresis on the onset value: on above NOTE_ON, off below NOTE_OFF
+  bool isPressed(int finger, int value) {
+    return fingerActive[finger] ? value >= noteOffThreshold : value > noteOnThreshold;
+  }
+
+  // Note-on velocity: from curl speed if features are attached, else from
+  // how far bent (the smooth value may still trail the threshold at onset)
+  uint8_t strikeVelocity(int finger, int position) {
+    if (features) {
+      float speed = features->getVelocity(finger);
+      if (speed <= 0) return minVelocity;
+      if (speed >= fullSpeed) return 127;
+      return minVelocity + (uint8_t)((127 - minVelocity) * speed / fullSpeed);
+    }
+    return map(constrain(position, noteOnThreshold, ANALOG_MAX),
+               noteOnThreshold, ANALOG_MAX, 64, 127);
+  }
+
 public:
-  PianoEvent process(int fingers[5], OperationMode mode) {
+  // Use curl speed from the shared feature extractor for note velocity
+  void setFeatures(const FingerFeatures* source) {
+    features = source;
+  }
+
+  // Publish note on/off and pitch bend events to `bus` (nullptr = off)
+  void setEventBus(EventBus* bus) {
+    events = bus;
+  }
+
+  // Note on above `on`, off below `off` (calibrated 0-ANALOG_MAX, off < on)
+  void setThresholds(int on, int off) {
+    noteOnThreshold = on;
+    noteOffThreshold = off;
+  }
+
+  // Curl speed (counts/s) that gives velocity 127, and the slowest press's velocity
+  void setVelocityCurve(float speed, uint8_t slowest) {
+    fullSpeed = speed;
+    minVelocity = slowest;
+  }
+
+  // frame.position: smoothed path, drives velocity and pitch bend
+  // frame.onset:    fast path (spike rejection only), decides note on/off so
+  //                 triggers aren't delayed by the smoothing filters
+  // Returns the frame's last event; with an event bus, a chord change
+  // publishes the old chord's note off and then the new chord's note on
+  PianoEvent process(const FingerFrame& frame, OperationMode mode) {
     PianoEvent event;
     event.hasEvent = false;
     event.type = PIANO_NOTE_OFF;
@@ -37,30 +103,52 @@ public:
 
     switch (mode) {
       case MODE_PIANO_SINGLE:
-        return processSingleNote(fingers);
+        event = processSingleNote(frame);
+        break;
 
       case MODE_PIANO_PITCH:
-        return processPitchBend(fingers);
+        event = processPitchBend(frame);
+        break;
 
       case MODE_PIANO_CHORD:
-        return processChord(fingers);
+        event = processChord(frame);
+        break;
 
       default:
         return event;
     }
+
+    if (event.hasEvent && events) {
+      publish(event, frame);
+    }
+    return event;
   }
 
 private:
+  void publish(const PianoEvent& note, const FingerFrame& frame) {
+    GloveEvent event = {};
+    switch (note.type) {
+      case PIANO_NOTE_ON:    event.type = EVENT_NOTE_ON; break;
+      case PIANO_PITCH_BEND: event.type = EVENT_PITCH_BEND; break;
+      default:               event.type = EVENT_NOTE_OFF; break;
+    }
+    event.timestampUs = frame.timestampUs;
+    event.seq = frame.seq;
+    event.piano = note;
+    events->publish(event);
+  }
+
   // Mode 1: Each finger triggers its own note
-  PianoEvent processSingleNote(int fingers[5]) {
+  PianoEvent processSingleNote(const FingerFrame& frame) {
+    const int16_t* onset = frame.onset;
     PianoEvent event;
     event.hasEvent = false;
     event.type = PIANO_NOTE_OFF;
     event.velocity = 100;
 
-    for (int i = 0; i < 5; i++) {
-      bool shouldBeActive = fingers[i] > NOTE_ON_THRESHOLD;    // Finger bent = note on
-      bool shouldBeInactive = fingers[i] < NOTE_OFF_THRESHOLD; // Finger extended = note off
+    for (int i = 0; i < FINGER_COUNT; i++) {
+      bool shouldBeActive = onset[i] > noteOnThreshold;    // Finger bent = note on
+      bool shouldBeInactive = onset[i] < noteOffThreshold; // Finger extended = note off
 
       // Note ON: finger just closed
       if (shouldBeActive && !fingerActive[i]) {
@@ -68,8 +156,7 @@ private:
         event.hasEvent = true;
         event.type = PIANO_NOTE_ON;
         event.note = baseNotes[i];
-        // Velocity based on how far bent (higher = louder)
-        event.velocity = map(fingers[i], NOTE_ON_THRESHOLD, ANALOG_MAX, 64, 127);
+        event.velocity = strikeVelocity(i, frame.position[i]);
         return event;
       }
 
@@ -88,16 +175,16 @@ private:
   }
 
   // Mode 2: Finger bend controls pitch
-  PianoEvent processPitchBend(int fingers[5]) {
+  PianoEvent processPitchBend(const FingerFrame& frame) {
     PianoEvent event;
     event.hasEvent = false;
 
     // Use index finger position to control pitch
     // Map 0-4095 to MIDI pitch bend range (-8192 to 8191)
-    int pitchBend = map(fingers[1], 0, ANALOG_MAX, -8192, 8191);
+    int pitchBend = map(frame.position[1], 0, ANALOG_MAX, -8192, 8191);
 
     // Use middle finger to trigger note on/off (bent = active)
-    bool noteActive = fingers[2] > NOTE_ON_THRESHOLD;
+    bool noteActive = isPressed(2, frame.onset[2]);
 
     // Note state change
     if (noteActive != fingerActive[2]) {
@@ -124,24 +211,25 @@ private:
   }
 
   // Mode 3: Finger combinations create chords
-  PianoEvent processChord(int fingers[5]) {
+  PianoEvent processChord(const FingerFrame& frame) {
     PianoEvent event;
     event.hasEvent = false;
     event.type = PIANO_CHORD;
     event.chordSize = 0;
 
     // Determine which fingers are active (bent = active)
-    bool active[5];
-    for (int i = 0; i < 5; i++) {
-      active[i] = fingers[i] > NOTE_ON_THRESHOLD;
+    bool active[FINGER_COUNT];
+    for (int i = 0; i < FINGER_COUNT; i++) {
+      active[i] = isPressed(i, frame.onset[i]);
+      fingerActive[i] = active[i];
     }
 
     // Build chord based on active fingers
-    uint8_t chord[5];
+    uint8_t chord[FINGER_COUNT];
     uint8_t chordSize = 0;
 
     // Each finger adds its note to the chord
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < FINGER_COUNT; i++) {
       if (active[i]) {
         chord[chordSize++] = baseNotes[i];
       }
@@ -165,6 +253,12 @@ private:
         event.type = PIANO_NOTE_OFF;
         memcpy(event.chord, lastChord, lastChordSize);
         event.chordSize = lastChordSize;
+
+        // Replaced by a new chord: its note off goes out first, here,
+        // so subscribers release the old notes before the new note on
+        if (chordSize > 0 && events) {
+          publish(event, frame);
+        }
       }
 
       // Update last chord
@@ -2,50 +2,259 @@
 
 #include <Arduino.h>
 #include "Config.h"
+#include "Logger.h"
+#include "filter/Pipeline.h"
+#include "MultiRate.h"
 
 // Filter configuration
 #define OVERSAMPLE_COUNT    4      // Number of oversampling reads per measurement
-#define FILTER_WINDOW_SIZE  5      // Median filter sliding window size
+#define FILTER_WINDOW_SIZE  5      // Median filter sliding window size (3/5 use a sorting network, larger stay sorted incrementally)
 #define EMA_ALPHA           0.3f   // Exponential moving average coefficient (0.1-0.5, higher = faster response)
 #define DEADZONE            15     // Deadzone threshold, ignore changes smaller than this value
+#define THUMB_OFFSET        (200 * ANALOG_MAX / 255)  // Thumb baseline correction (~200 on 0-255 scale)
+// #define FILTER_FLOAT_EMA          // Uncomment to run the EMA in float instead of Q15 fixed point
+#define FILTER_AUTO_TUNE             // Per-finger EMA alpha and deadzone from measured rest noise (EMA_ALPHA/DEADZONE are the start values)
+
+// Median / EMA / deadzone count samples, not time: their constants are for
+// this rate. With the ADC engine a faster stream feeds those chains a
+// CIC-decimated copy and holds their output in between (the onset path and
+// the time-aware One-Euro / Kalman chains still see every frame).
+#define SMOOTH_RATE_HZ      100
+
+// Piano chain: short median and fast EMA, no deadzone (quick note onsets)
+#define PIANO_WINDOW_SIZE   3
+#define PIANO_EMA_ALPHA     0.6f
+
+// Onset path: spike rejection only, published next to the filtered output
+// for note triggers (AirPiano), so they don't wait for the smoothing
+#define ONSET_WINDOW_SIZE   3
+
+// One-Euro mode defaults (per-finger override with setOneEuroParams)
+#define ONE_EURO_MIN_CUTOFF        0.5f    // Hz at rest
+#define ONE_EURO_THUMB_MIN_CUTOFF  0.3f    // Thumb sensor is noisier
+#define ONE_EURO_BETA              0.001f  // Cutoff increase per count/s of speed
+#define ONE_EURO_D_CUTOFF          1.0f    // Hz for the speed estimate
+
+// Kalman mode defaults (per-finger override with setKalmanParams)
+#define KALMAN_PROCESS_NOISE       20000.0f  // counts/s^2, finger acceleration
+#define KALMAN_MEASUREMENT_NOISE   8.0f      // counts, sensor noise
+#define KALMAN_LEAD_MS             10        // Prediction horizon to offset pipeline + link latency
+
+// Filter profile: which chain(s) this build compiles in
+// Define one of these (e.g. in Config.h) for a single-purpose firmware:
+//   FILTER_PROFILE_GESTURE     - median + EMA + deadzone only
+//   FILTER_PROFILE_PIANO       - short median + fast EMA only
+//   FILTER_PROFILE_OPENGLOVES  - One-Euro only
+//   FILTER_PROFILE_PREDICTIVE  - Kalman with prediction only
+// Default (FILTER_PROFILE_FULL) has EMA, One-Euro and Kalman, switched at runtime
+#if !defined(FILTER_PROFILE_GESTURE) && !defined(FILTER_PROFILE_PIANO) && \
+    !defined(FILTER_PROFILE_OPENGLOVES) && !defined(FILTER_PROFILE_PREDICTIVE)
+#define FILTER_PROFILE_FULL
+#endif
+
+// ============ FILTER CHAINS ============
+// Stages run left to right after the source; see filter/Pipeline.h
+
+typedef Oversample<OVERSAMPLE_COUNT> FilterSource;
+typedef ChannelOffset<0, THUMB_OFFSET> ThumbOffset;  // Poor contact causes high thumb baseline
+
+#ifdef FILTER_FLOAT_EMA
+typedef FloatEma<Q15(EMA_ALPHA)> SmoothEma;
+#else
+typedef Ema<Q15(EMA_ALPHA)> SmoothEma;
+#endif
+typedef AutoSmooth<Q15(EMA_ALPHA), DEADZONE> AutoSmoothStage;
+
+// Gesture: smoothest output, most lag
+#ifdef FILTER_AUTO_TUNE
+typedef Pipeline<FilterSource, ThumbOffset, Median<FILTER_WINDOW_SIZE>, AutoSmoothStage> SmoothFilterChain;
+#else
+typedef Pipeline<FilterSource, ThumbOffset, Median<FILTER_WINDOW_SIZE>, SmoothEma, Deadzone<DEADZONE>> SmoothFilterChain;
+#endif
+
+// Piano: spike rejection with little delay
+typedef Pipeline<FilterSource, ThumbOffset, Median<PIANO_WINDOW_SIZE>, Ema<Q15(PIANO_EMA_ALPHA)>> PianoFilterChain;
+
+// Onset: oversample + short median, no smoothing; runs on every frame
+typedef Pipeline<FilterSource, ThumbOffset, Median<ONSET_WINDOW_SIZE>> OnsetFilterChain;
+
+// OpenGloves: speed-adaptive, low lag when moving
+typedef Pipeline<FilterSource, ThumbOffset, OneEuro> AdaptiveFilterChain;
+
+// VR: constant-velocity Kalman, output predicted KALMAN_LEAD_MS ahead
+typedef Pipeline<FilterSource, ThumbOffset, Kalman> PredictiveFilterChain;
+
+#if defined(FILTER_PROFILE_OPENGLOVES)
+typedef AdaptiveFilterChain PrimaryFilterChain;
+#elif defined(FILTER_PROFILE_PREDICTIVE)
+typedef PredictiveFilterChain PrimaryFilterChain;
+#elif defined(FILTER_PROFILE_PIANO)
+typedef PianoFilterChain PrimaryFilterChain;
+#else
+typedef SmoothFilterChain PrimaryFilterChain;
+#endif
+
+// Constants that can be changed at runtime (SET, see Params.h)
+struct FilterTuning {
+  float oneEuroMinCutoff;       // Hz, fingers
+  float oneEuroThumbMinCutoff;  // Hz, thumb
+  float oneEuroBeta;
+  float oneEuroDCutoff;
+  float kalmanProcessNoise;
+  float kalmanMeasurementNoise;
+  float kalmanLeadMs;
+  uint16_t gestureRateHz;       // STREAM_GESTURE (ADC engine only)
+  uint16_t hostRateHz;          // STREAM_HOST (ADC engine only)
+
+  // Values from the config above
+  static FilterTuning defaults() {
+    FilterTuning t;
+    t.oneEuroMinCutoff = ONE_EURO_MIN_CUTOFF;
+    t.oneEuroThumbMinCutoff = ONE_EURO_THUMB_MIN_CUTOFF;
+    t.oneEuroBeta = ONE_EURO_BETA;
+    t.oneEuroDCutoff = ONE_EURO_D_CUTOFF;
+    t.kalmanProcessNoise = KALMAN_PROCESS_NOISE;
+    t.kalmanMeasurementNoise = KALMAN_MEASUREMENT_NOISE;
+    t.kalmanLeadMs = KALMAN_LEAD_MS;
+    t.gestureRateHz = GESTURE_RATE_HZ;
+    t.hostRateHz = HOST_RATE_HZ;
+    return t;
+  }
+};
+
+// Filter modes (selectable at runtime in FILTER_PROFILE_FULL builds)
+enum FilterMode {
+  FILTER_MODE_EMA = 0,    // Median + EMA (+ deadzone)
+  FILTER_MODE_ONE_EURO,   // Speed-adaptive One-Euro (low lag when moving)
+  FILTER_MODE_KALMAN,     // Kalman with velocity state and prediction
+  FILTER_MODE_COUNT
+};
 
 class AnalogFilter {
 private:
-  // Filter state for each finger
-  int window[5][FILTER_WINDOW_SIZE];  // Median filter window
-  int windowIndex[5];                  // Current write position in window
-  float emaValue[5];                   // Current EMA value
-  int lastOutput[5];                   // Last output value (for deadzone)
-  bool initialized[5];                 // Whether initialized
+  PrimaryFilterChain primary;
+#ifdef FILTER_PROFILE_FULL
+  AdaptiveFilterChain adaptive;
+  PredictiveFilterChain predictive;
+  FilterMode mode;
+#endif
+  OnsetFilterChain onset;
+  unsigned long lastSampleUs;
+  unsigned long lastIntervalUs;   // Capture time between the last two outputs
+  int lastOutput[SENSOR_COUNT];
+  int onsetOutput[SENSOR_COUNT];
+
+#ifdef ENABLE_ADC_ENGINE
+  AcquisitionEngine adc;
+  MultiRateSampler sampler;
+  SampleStream stream;
+  CicDecimator<SENSOR_COUNT, DECIMATOR_ORDER> chainDecimator;  // Stream -> SMOOTH_RATE_HZ
+  uint16_t chainRateHz;       // Rate the active chain is stepped at
+  bool chainSeeded;           // Stepped once since reset() (on a full-rate frame)
 
-  // Pin mapping
-  int pins[5];
-  bool inverted[5];
+  // Per-sample chains step at most SMOOTH_RATE_HZ; a change of their rate
+  // changes the noise they see, so the auto-tuned smoothing starts over
+  template <class Chain>
+  void updateChainRate(Chain& chain) {
+    uint16_t rate = sampler.getRate(stream);
+    bool timeAware = chain.template stage<OneEuro>() || chain.template stage<Kalman>();
+    uint16_t ratio = (timeAware || rate <= SMOOTH_RATE_HZ) ? 1 : rate / SMOOTH_RATE_HZ;
+    if (ratio != chainDecimator.getRatio()) {
+      chainDecimator.setRatio(ratio);
+      chainSeeded = false;
+    }
+    if (rate / ratio != chainRateHz) {
+      chainRateHz = rate / ratio;
+      if (AutoSmoothStage* smooth = getAutoSmooth()) smooth->retrain();
+    }
+  }
+#endif
+
+  // Feed one frame through chain; all channels share the frame's timestamp
+  template <class Chain>
+  bool runChain(Chain& chain, int output[SENSOR_COUNT]) {
+#ifdef ENABLE_ADC_ENGINE
+    updateChainRate(chain);
+
+    // Decimate queued frames until the active stream has a new output;
+    // the rest stay queued for the next call so no output is skipped
+    adc.service();
+    AdcFrame frame;
+    bool ready = false;
+    while (!ready && adc.read(frame)) {
+      sampler.push(frame);
+      for (int i = 0; i < SENSOR_COUNT; i++) {
+        onsetOutput[i] = onset.process(i, frame.value[i]);
+      }
+      ready = sampler.read(stream, frame);
+    }
+    if (!ready) {
+      // Nothing new at this rate: keep the previous output, don't step the filters
+      for (int i = 0; i < SENSOR_COUNT; i++) {
+        output[i] = lastOutput[i];
+      }
+      return false;
+    }
+    unsigned long now = frame.timestampUs;
+#else
+    unsigned long now = micros();
+#endif
+
+    // Time step for the speed-adaptive filter
+    lastIntervalUs = now - lastSampleUs;
+    float dt = lastIntervalUs / 1000000.0f;
+    lastSampleUs = now;
+
+#ifdef ENABLE_ADC_ENGINE
+    // Decimated chain: step it when the decimator has an output, hold otherwise
+    if (chainDecimator.getRatio() > 1 && chainSeeded) {
+      int slow[SENSOR_COUNT];
+      if (chainDecimator.push(frame.value, slow)) {
+        for (int i = 0; i < SENSOR_COUNT; i++) {
+          lastOutput[i] = chain.process(i, slow[i]);
+        }
+      }
+      for (int i = 0; i < SENSOR_COUNT; i++) {
+        output[i] = lastOutput[i];
+      }
+      return true;
+    }
+    chainSeeded = true;   // First frame seeds the chain directly
+#endif
+    chain.setTimeStep(dt);
+
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+#ifdef ENABLE_ADC_ENGINE
+      output[i] = chain.process(i, frame.value[i]);
+#else
+      // One acquisition feeds both paths
+      int x = FilterSource::acquire(SENSOR_PINS[i], SENSOR_INVERTED[i]);
+      output[i] = chain.process(i, x);
+      onsetOutput[i] = onset.process(i, x);
+#endif
+      lastOutput[i] = output[i];
+    }
+    return true;
+  }
 
 public:
   AnalogFilter() {
-    // Initialize pins
-    pins[0] = PIN_THUMB;
-    pins[1] = PIN_INDEX;
-    pins[2] = PIN_MIDDLE;
-    pins[3] = PIN_RING;
-    pins[4] = PIN_PINKY;
-
-    inverted[0] = INVERT_THUMB;
-    inverted[1] = INVERT_INDEX;
-    inverted[2] = INVERT_MIDDLE;
-    inverted[3] = INVERT_RING;
-    inverted[4] = INVERT_PINKY;
-
-    for (int i = 0; i < 5; i++) {
-      windowIndex[i] = 0;
-      emaValue[i] = 0;
+#ifdef FILTER_PROFILE_FULL
+    mode = FILTER_MODE_EMA;
+#endif
+#ifdef ENABLE_ADC_ENGINE
+    stream = STREAM_FULL;
+    chainRateHz = 0;
+    chainSeeded = false;
+#endif
+    lastSampleUs = 0;
+    lastIntervalUs = 0;
+
+    for (int i = 0; i < SENSOR_COUNT; i++) {
       lastOutput[i] = 0;
-      initialized[i] = false;
-      for (int j = 0; j < FILTER_WINDOW_SIZE; j++) {
-        window[i][j] = 0;
-      }
+      onsetOutput[i] = 0;
     }
+    setTuning(FilterTuning::defaults());
   }
 
   void begin() {
@@ -55,100 +264,242 @@ public:
     analogSetAttenuation(ADC_11db);  // Full range 0-3.3V
     #endif
 
+    #ifdef ENABLE_ADC_ENGINE
+    if (!adc.begin(SENSOR_PINS, SENSOR_INVERTED)) {
+      logger.println("ADC engine failed to start!");
+    }
+    #endif
+
+#ifndef ENABLE_FAST_BOOT
     // Warm-up: read a few times to initialize the filter
     for (int i = 0; i < FILTER_WINDOW_SIZE * 2; i++) {
-      int dummy[5];
+      int dummy[SENSOR_COUNT];
       readFiltered(dummy);
       delay(5);
     }
+#endif
+    // (Fast boot: every stage seeds itself from the first sample)
   }
 
   // Read raw value from a single pin (with oversampling)
   int readRawOversampled(int pin, bool invert) {
-    long sum = 0;
-    for (int i = 0; i < OVERSAMPLE_COUNT; i++) {
-      sum += analogRead(pin);
+    return FilterSource::acquire(pin, invert);
+  }
+
+  // Read filtered values for all channels at the given stream's rate
+  // Returns false (output = previous values) if the stream has no new sample
+  // yet. Switching streams reseeds the filters; per-sample chains run at
+  // most SMOOTH_RATE_HZ whatever the stream (see above).
+  // Without the ADC engine there is one sample per call and stream is ignored.
+  bool readFiltered(int output[SENSOR_COUNT], SampleStream newStream = STREAM_FULL) {
+#ifdef ENABLE_ADC_ENGINE
+    if (newStream != stream) {
+      stream = newStream;
+      reset();
     }
-    int value = sum / OVERSAMPLE_COUNT;
+#else
+    (void)newStream;
+#endif
 
-    if (invert) {
-      value = ANALOG_MAX - value;
+#ifdef FILTER_PROFILE_FULL
+    switch (mode) {
+      case FILTER_MODE_ONE_EURO:
+        return runChain(adaptive, output);
+      case FILTER_MODE_KALMAN:
+        return runChain(predictive, output);
+      default:
+        break;
     }
-    return value;
+#endif
+    return runChain(primary, output);
   }
 
-  // Median filter: return the median value in the window
-  int getMedian(int finger) {
-    // Copy window data and sort
-    int sorted[FILTER_WINDOW_SIZE];
-    for (int i = 0; i < FILTER_WINDOW_SIZE; i++) {
-      sorted[i] = window[finger][i];
-    }
+  // Capture time of the last output (micros)
+  uint32_t getLastTimestampUs() const { return lastSampleUs; }
 
-    // Simple bubble sort (window is small, efficiency is sufficient)
-    for (int i = 0; i < FILTER_WINDOW_SIZE - 1; i++) {
-      for (int j = 0; j < FILTER_WINDOW_SIZE - i - 1; j++) {
-        if (sorted[j] > sorted[j + 1]) {
-          int temp = sorted[j];
-          sorted[j] = sorted[j + 1];
-          sorted[j + 1] = temp;
-        }
-      }
+  // Measured time between the capture of the last two outputs, in ms
+  // (frame timestamps with the ADC engine, loop timing without)
+  uint16_t getIntervalMs() const {
+    unsigned long ms = (lastIntervalUs + 500) / 1000;
+    return ms > 0xFFFF ? 0xFFFF : (uint16_t)ms;
+  }
+
+  // Sample rate of a stream (the loop rate without the ADC engine)
+  uint16_t getRate(SampleStream s) const {
+#ifdef ENABLE_ADC_ENGINE
+    return sampler.getRate(s);
+#else
+    (void)s;
+    return 1000 / LOOP_DELAY_MS;
+#endif
+  }
+
+  // Sample period of a stream (the loop period without the ADC engine)
+  uint16_t getPeriodMs(SampleStream s) const {
+#ifdef ENABLE_ADC_ENGINE
+    return sampler.getPeriodMs(s);
+#else
+    (void)s;
+    return LOOP_DELAY_MS;
+#endif
+  }
+
+  // Onset path: spike-rejected but unsmoothed values of the newest frame
+  // (every frame is processed, whatever the stream). Updated by readFiltered().
+  void readOnset(int output[SENSOR_COUNT]) const {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      output[i] = onsetOutput[i];
     }
+  }
 
-    return sorted[FILTER_WINDOW_SIZE / 2];
+  // Read raw values (no filtering, for debugging)
+  void readRaw(int output[SENSOR_COUNT]) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      output[i] = readRawOversampled(SENSOR_PINS[i], SENSOR_INVERTED[i]);
+    }
   }
 
-  // Read filtered values for all fingers
-  void readFiltered(int output[5]) {
-    for (int i = 0; i < 5; i++) {
-      // 1. Read raw value with oversampling
-      int raw = readRawOversampled(pins[i], inverted[i]);
+  // Input transform in front of the filters (for calibration linearization)
+  bool isInverted(int finger) const { return SENSOR_INVERTED[finger]; }
+  int getPin(int finger) const { return SENSOR_PINS[finger]; }
+  int getInputOffset(int finger) const { return ThumbOffset::offset(finger); }
 
-      // 2. Thumb offset correction (poor contact causes high baseline)
-      if (i == 0) {
-        raw = max(0, raw - 200 * ANALOG_MAX / 255);  // Subtract ~200 (on 0-255 scale)
-      }
+  // Reset filter state (use after calibration)
+  void reset() {
+    primary.reset();
+    onset.reset();
+#ifdef ENABLE_ADC_ENGINE
+    chainDecimator.reset();
+    chainSeeded = false;
+#endif
+#ifdef FILTER_PROFILE_FULL
+    adaptive.reset();
+    predictive.reset();
+#endif
+  }
 
-      // 3. Update median filter window
-      window[i][windowIndex[i]] = raw;
-      windowIndex[i] = (windowIndex[i] + 1) % FILTER_WINDOW_SIZE;
+  // Stop sampling while idle (power saving)
+  void pause() {
+#ifdef ENABLE_ADC_ENGINE
+    adc.pause();
+#endif
+  }
 
-      // 4. Get median value
-      int median = getMedian(i);
+  // Sample again after pause(); filters reseed from the first new frame
+  void resume() {
+#ifdef ENABLE_ADC_ENGINE
+    adc.resume();
+    sampler.reset();
+#endif
+    reset();
+  }
 
-      // 5. Apply exponential moving average
-      if (!initialized[i]) {
-        emaValue[i] = median;
-        lastOutput[i] = median;
-        initialized[i] = true;
-      } else {
-        emaValue[i] = EMA_ALPHA * median + (1.0f - EMA_ALPHA) * emaValue[i];
-      }
+  // Switch filter mode; state is reseeded from the next sample
+  // Single-profile builds have exactly one chain and ignore this
+  void setMode(FilterMode newMode) {
+#ifdef FILTER_PROFILE_FULL
+    mode = newMode;
+    reset();
+#else
+    (void)newMode;
+#endif
+  }
 
-      int filtered = (int)emaValue[i];
+  FilterMode getMode() const {
+#if defined(FILTER_PROFILE_FULL)
+    return mode;
+#elif defined(FILTER_PROFILE_OPENGLOVES)
+    return FILTER_MODE_ONE_EURO;
+#elif defined(FILTER_PROFILE_PREDICTIVE)
+    return FILTER_MODE_KALMAN;
+#else
+    return FILTER_MODE_EMA;
+#endif
+  }
 
-      // 6. Apply deadzone (reduce jitter)
-      if (abs(filtered - lastOutput[i]) > DEADZONE) {
-        lastOutput[i] = filtered;
-      }
+  const char* getModeName() const {
+    return modeName(getMode());
+  }
 
-      output[i] = lastOutput[i];
+  static const char* modeName(FilterMode m) {
+    switch (m) {
+      case FILTER_MODE_ONE_EURO: return "One-Euro";
+      case FILTER_MODE_KALMAN:   return "Kalman";
+      default:                   return "EMA";
     }
   }
 
-  // Read raw values (no filtering, for debugging)
-  void readRaw(int output[5]) {
-    for (int i = 0; i < 5; i++) {
-      output[i] = readRawOversampled(pins[i], inverted[i]);
-    }
+  void setOneEuroParams(int finger, const OneEuroParams& params) {
+    if (finger < 0 || finger >= SENSOR_COUNT) return;
+    if (OneEuro* stage = primary.stage<OneEuro>()) stage->setParams(finger, params);
+#ifdef FILTER_PROFILE_FULL
+    adaptive.stage<OneEuro>()->setParams(finger, params);
+#endif
   }
 
-  // Reset filter state (use after calibration)
-  void reset() {
-    for (int i = 0; i < 5; i++) {
-      initialized[i] = false;
-      windowIndex[i] = 0;
+  void setKalmanParams(int finger, const KalmanParams& params) {
+    if (finger < 0 || finger >= SENSOR_COUNT) return;
+    if (Kalman* stage = primary.stage<Kalman>()) stage->setParams(finger, params);
+#ifdef FILTER_PROFILE_FULL
+    predictive.stage<Kalman>()->setParams(finger, params);
+#endif
+  }
+
+  // How far ahead the Kalman output is extrapolated
+  void setPredictionMs(float ms) {
+    if (Kalman* stage = primary.stage<Kalman>()) stage->setLeadMs(ms);
+#ifdef FILTER_PROFILE_FULL
+    predictive.stage<Kalman>()->setLeadMs(ms);
+#endif
+  }
+
+  // Apply every runtime constant; filter state is kept, a changed rate
+  // restarts that stream's decimator
+  void setTuning(const FilterTuning& t) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      OneEuroParams params;
+      params.minCutoff = (i == 0) ? t.oneEuroThumbMinCutoff : t.oneEuroMinCutoff;
+      params.beta = t.oneEuroBeta;
+      params.dCutoff = t.oneEuroDCutoff;
+      setOneEuroParams(i, params);
+
+      KalmanParams kalman;
+      kalman.processNoise = t.kalmanProcessNoise;
+      kalman.measurementNoise = t.kalmanMeasurementNoise;
+      setKalmanParams(i, kalman);
     }
+    setPredictionMs(t.kalmanLeadMs);
+#ifdef ENABLE_ADC_ENGINE
+    sampler.setRate(STREAM_GESTURE, t.gestureRateHz);
+    sampler.setRate(STREAM_HOST, t.hostRateHz);
+#endif
+  }
+
+#ifdef ENABLE_ADC_ENGINE
+  AcquisitionEngine& getAdc() { return adc; }
+  MultiRateSampler& getSampler() { return sampler; }
+#endif
+
+  // Noise-tuned smoothing stage (nullptr if this build has none)
+  AutoSmoothStage* getAutoSmooth() {
+    return primary.stage<AutoSmoothStage>();
+  }
+
+  // Estimated finger velocity in counts/s (positive = closing)
+  // Available in One-Euro and Kalman modes, 0 in EMA mode
+  float getVelocity(int finger) {
+#ifdef FILTER_PROFILE_FULL
+    if (mode == FILTER_MODE_ONE_EURO) return chainVelocity(adaptive, finger);
+    if (mode == FILTER_MODE_KALMAN) return chainVelocity(predictive, finger);
+#endif
+    return chainVelocity(primary, finger);
+  }
+
+private:
+  template <class Chain>
+  static float chainVelocity(Chain& chain, int finger) {
+    if (OneEuro* stage = chain.template stage<OneEuro>()) return stage->getSpeed(finger);
+    if (Kalman* stage = chain.template stage<Kalman>()) return stage->getVelocity(finger);
+    return 0;
   }
 };
@@ -2,12 +2,14 @@
 
 #include <EEPROM.h>
 #include "Config.h"
+#include "PositionMap.h"
+#include "Logger.h"
 
 class Calibration {
 public:
   // Calibration boundaries
-  int minVal[5] = {0, 0, 0, 0, 0};
-  int maxVal[5] = {4095, 4095, 4095, 4095, 4095};
+  int minVal[SENSOR_COUNT];
+  int maxVal[SENSOR_COUNT];
   bool isCalibrating = false;
   bool hasValidCalibration = false;
 
@@ -15,17 +17,20 @@ private:
   // Histogram for percentile calculation (256 bins, each represents 16 ADC values)
   static const int HISTOGRAM_BINS = 256;
   static const int BIN_SIZE = 16;  // 4096 / 256
-  uint16_t histogram[5][HISTOGRAM_BINS];
-  uint32_t totalSamples[5];
+  uint16_t histogram[SENSOR_COUNT][HISTOGRAM_BINS];
+  uint32_t totalSamples[SENSOR_COUNT];
 
-  // Debounce buffer
+  // Debounce buffer, one row per frame (all channels advance together)
   static const int STABLE_BUFFER_SIZE = 5;
-  int stableBuffer[5][STABLE_BUFFER_SIZE];
-  int bufferIndex[5];
-  bool bufferFilled[5];
+  int stableBuffer[STABLE_BUFFER_SIZE][SENSOR_COUNT];
+  int bufferIndex;
+  bool bufferFilled;
 
   int sampleCount;
 
+  // Per-finger scale factors, rebuilt whenever minVal/maxVal change
+  PositionMap positions;
+
   // Configuration
   static const int MARGIN_PERCENT = 5;      // Range margin percentage
   static const int MIN_RANGE = 500;         // Minimum valid range
@@ -34,6 +39,13 @@ private:
   static const int STABLE_THRESHOLD = 50;   // Debounce threshold: max difference in buffer
 
 public:
+  Calibration() : sampleCount(0) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      minVal[i] = 0;
+      maxVal[i] = ANALOG_MAX;
+    }
+  }
+
   void begin() {
     EEPROM.begin(EEPROM_SIZE);
     loadFromEEPROM();
@@ -44,60 +56,80 @@ public:
     sampleCount = 0;
 
     // Clear histogram
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
       for (int j = 0; j < HISTOGRAM_BINS; j++) {
         histogram[i][j] = 0;
       }
       totalSamples[i] = 0;
-      bufferIndex[i] = 0;
-      bufferFilled[i] = false;
-      for (int j = 0; j < STABLE_BUFFER_SIZE; j++) {
-        stableBuffer[i][j] = 0;
+    }
+    bufferIndex = 0;
+    bufferFilled = false;
+    for (int j = 0; j < STABLE_BUFFER_SIZE; j++) {
+      for (int i = 0; i < SENSOR_COUNT; i++) {
+        stableBuffer[j][i] = 0;
       }
     }
 
-    Serial.println();
-    Serial.println("****************************************");
-    Serial.println("*       CALIBRATION MODE ACTIVE        *");
-    Serial.println("****************************************");
-    Serial.println();
-    Serial.println("Improved calibration with:");
-    Serial.println("  - Debounce filtering (stable readings only)");
-    Serial.println("  - Percentile-based range (excludes outliers)");
-    Serial.println();
-    Serial.println("Move ALL fingers through full range:");
-    Serial.println("  1. Make a tight fist (curl all fingers)");
-    Serial.println("  2. Open hand fully (extend all fingers)");
-    Serial.println("  3. Hold each position for 1-2 seconds");
-    Serial.println("  4. Repeat 3-5 times slowly");
-    Serial.println();
-    Serial.println("Type 'DONE' or press ENTER when finished.");
-    Serial.println();
+#ifndef ENABLE_HELP_TEXT
+    logger.println("Calibrating: move all fingers through full range, then 'DONE'.");
+#else
+    logger.println();
+    logger.println("****************************************");
+    logger.println("*       CALIBRATION MODE ACTIVE        *");
+    logger.println("****************************************");
+    logger.println();
+    logger.println("Improved calibration with:");
+    logger.println("  - Debounce filtering (stable readings only)");
+    logger.println("  - Percentile-based range (excludes outliers)");
+    logger.println();
+    logger.println("Move ALL fingers through full range:");
+    logger.println("  1. Make a tight fist (curl all fingers)");
+    logger.println("  2. Open hand fully (extend all fingers)");
+    logger.println("  3. Hold each position for 1-2 seconds");
+    logger.println("  4. Repeat 3-5 times slowly");
+    logger.println();
+    logger.println("Type 'DONE' or press ENTER when finished.");
+    logger.println();
+#endif
   }
 
-  void update(int raw[5]) {
+  void update(const int raw[SENSOR_COUNT]) {
     if (!isCalibrating) return;
 
     sampleCount++;
 
-    for (int i = 0; i < 5; i++) {
-      int value = raw[i];
+    // Update debounce buffer
+    int* row = stableBuffer[bufferIndex];
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      row[i] = raw[i];
+    }
+    bufferIndex = (bufferIndex + 1) % STABLE_BUFFER_SIZE;
+    if (bufferIndex == 0) {
+      bufferFilled = true;
+    }
 
-      // Update debounce buffer
-      stableBuffer[i][bufferIndex[i]] = value;
-      bufferIndex[i] = (bufferIndex[i] + 1) % STABLE_BUFFER_SIZE;
-      if (bufferIndex[i] == 0) {
-        bufferFilled[i] = true;
-      }
+    // Only check stability after buffer is filled
+    if (!bufferFilled) return;
 
-      // Only check stability after buffer is filled
-      if (!bufferFilled[i]) continue;
+    // Spread of every channel over the buffer, one row at a time
+    int lo[SENSOR_COUNT], hi[SENSOR_COUNT];
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      lo[i] = hi[i] = stableBuffer[0][i];
+    }
+    for (int j = 1; j < STABLE_BUFFER_SIZE; j++) {
+      for (int i = 0; i < SENSOR_COUNT; i++) {
+        int v = stableBuffer[j][i];
+        if (v < lo[i]) lo[i] = v;
+        if (v > hi[i]) hi[i] = v;
+      }
+    }
 
+    for (int i = 0; i < SENSOR_COUNT; i++) {
       // Check if stable (values in buffer differ less than threshold)
-      if (!isStable(i)) continue;
+      if (hi[i] - lo[i] > STABLE_THRESHOLD) continue;
 
       // When stable, add value to histogram
-      int bin = constrain(value / BIN_SIZE, 0, HISTOGRAM_BINS - 1);
+      int bin = constrain(raw[i] / BIN_SIZE, 0, HISTOGRAM_BINS - 1);
       if (histogram[i][bin] < 65535) {  // Prevent overflow
         histogram[i][bin]++;
         totalSamples[i]++;
@@ -106,11 +138,11 @@ public:
   }
 
   bool isStable(int finger) {
-    int minV = stableBuffer[finger][0];
-    int maxV = stableBuffer[finger][0];
+    int minV = stableBuffer[0][finger];
+    int maxV = stableBuffer[0][finger];
     for (int j = 1; j < STABLE_BUFFER_SIZE; j++) {
-      if (stableBuffer[finger][j] < minV) minV = stableBuffer[finger][j];
-      if (stableBuffer[finger][j] > maxV) maxV = stableBuffer[finger][j];
+      if (stableBuffer[j][finger] < minV) minV = stableBuffer[j][finger];
+      if (stableBuffer[j][finger] > maxV) maxV = stableBuffer[j][finger];
     }
     return (maxV - minV) <= STABLE_THRESHOLD;
   }
@@ -131,84 +163,57 @@ public:
     return 4095;
   }
 
-  void printStatus(int raw[5]) {
-    const char* names[] = {"T", "I", "M", "R", "P"};
-    Serial.print("Samples: ");
-    Serial.print(sampleCount);
-    Serial.print(" (stable: ");
-
+  void printStatus(const int raw[SENSOR_COUNT]) {
     uint32_t totalStable = 0;
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
       totalStable += totalSamples[i];
     }
-    Serial.print(totalStable / 5);
-    Serial.print(") | ");
+    logger.print("Samples: %d (stable: %lu) | ", sampleCount, totalStable / SENSOR_COUNT);
 
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
       int p2 = getPercentile(i, PERCENTILE_LOW);
       int p98 = getPercentile(i, PERCENTILE_HIGH);
       int range = p98 - p2;
 
-      Serial.print(names[i]);
-      Serial.print(":");
-      Serial.print(raw[i]);
-
-      // Display stability status
-      if (isStable(i)) {
-        Serial.print("*");  // Stable marker
+      // Fingers by initial, extra sensors by channel number
+      if (i < FINGER_COUNT) {
+        logger.print("%c:", SENSOR_NAMES[i][0]);
       } else {
-        Serial.print(" ");
-      }
-
-      Serial.print("[");
-      Serial.print(p2);
-      Serial.print("-");
-      Serial.print(p98);
-      Serial.print("]");
-
-      if (range < MIN_RANGE) {
-        Serial.print("!");  // Insufficient range warning
+        logger.print("%d:", i);
       }
-      Serial.print(" ");
+      // '*' = stable, '!' = insufficient range
+      logger.print("%d%c[%d-%d]%s ", raw[i], isStable(i) ? '*' : ' ',
+                   p2, p98, range < MIN_RANGE ? "!" : "");
     }
-    Serial.println();
+    logger.println();
   }
 
   void stopCalibration() {
     isCalibrating = false;
 
-    Serial.println();
-    Serial.println("****************************************");
-    Serial.println("*       CALIBRATION COMPLETE!          *");
-    Serial.println("****************************************");
-    Serial.println();
-    Serial.print("Total samples: ");
-    Serial.print(sampleCount);
-    Serial.print(" (stable samples per finger: ~");
+    logger.println();
+    logger.println("****************************************");
+    logger.println("*       CALIBRATION COMPLETE!          *");
+    logger.println("****************************************");
+    logger.println();
     uint32_t avgStable = 0;
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
       avgStable += totalSamples[i];
     }
-    Serial.print(avgStable / 5);
-    Serial.println(")");
-    Serial.println();
-    Serial.println("Results (2nd - 98th percentile):");
+    logger.println("Total samples: %d (stable samples per sensor: ~%lu)", sampleCount, avgStable / SENSOR_COUNT);
+    logger.println();
+    logger.println("Results (2nd - 98th percentile):");
 
-    const char* names[] = {"Thumb ", "Index ", "Middle", "Ring  ", "Pinky "};
     bool allGood = true;
 
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
       int p2 = getPercentile(i, PERCENTILE_LOW);
       int p98 = getPercentile(i, PERCENTILE_HIGH);
       int rawRange = p98 - p2;
 
       // Check if there is valid data
       if (totalSamples[i] < 100 || rawRange < 100) {
-        Serial.print("  ");
-        Serial.print(names[i]);
-        Serial.print(": NO DATA (");
-        Serial.print(totalSamples[i]);
-        Serial.println(" samples) - move finger more slowly!");
+        logger.println("  %s: NO DATA (%lu samples) - move finger more slowly!", SENSOR_NAMES[i], totalSamples[i]);
         minVal[i] = 0;
         maxVal[i] = 4095;
         allGood = false;
@@ -222,52 +227,69 @@ public:
 
       int finalRange = maxVal[i] - minVal[i];
 
-      Serial.print("  ");
-      Serial.print(names[i]);
-      Serial.print(": ");
-      Serial.print(minVal[i]);
-      Serial.print(" -> ");
-      Serial.print(maxVal[i]);
-      Serial.print("  (range: ");
-      Serial.print(finalRange);
+      logger.print("  %s: %d -> %d  (range: %d", SENSOR_NAMES[i], minVal[i], maxVal[i], finalRange);
 
       if (rawRange < MIN_RANGE) {
-        Serial.println(" WARNING: low range!)");
+        logger.println(" WARNING: low range!)");
         allGood = false;
       } else {
-        Serial.println(" OK)");
+        logger.println(" OK)");
       }
     }
 
-    Serial.println();
+    logger.println();
     if (allGood) {
-      Serial.println("Calibration OK! All fingers have good range.");
+      logger.println("Calibration OK! All fingers have good range.");
     } else {
-      Serial.println("WARNING: Some fingers have limited range.");
-      Serial.println("Try 'CAL' again, hold positions longer.");
+      logger.println("WARNING: Some fingers have limited range.");
+      logger.println("Try 'CAL' again, hold positions longer.");
     }
 
     hasValidCalibration = true;
+    rebuildMap();
     saveToEEPROM();
-    Serial.println("Saved to EEPROM.");
-    Serial.println("****************************************");
-    Serial.println();
+    logger.println("Saved to EEPROM.");
+    logger.println("****************************************");
+    logger.println();
   }
 
   // Map raw value to 0-ANALOG_MAX using calibration
-  int mapValue(int finger, int rawValue) {
-    if (finger < 0 || finger >= 5) return rawValue;
-    if (maxVal[finger] <= minVal[finger]) return rawValue;
+  int mapValue(int finger, int rawValue) const {
+    if (finger < 0 || finger >= SENSOR_COUNT) return rawValue;
+    return positions.map(finger, rawValue);
+  }
+
+  // Map raw value straight to the 0-255 gesture scale
+  uint8_t normalizeValue(int finger, int rawValue) const {
+    if (finger < 0 || finger >= SENSOR_COUNT) return 0;
+    return positions.normalize(finger, rawValue);
+  }
+
+  // Calibrated (0-ANALOG_MAX) and 0-255 positions of a whole frame
+  void mapFrame(const int value[SENSOR_COUNT], int16_t position[SENSOR_COUNT],
+                uint8_t normalized[SENSOR_COUNT]) const {
+    positions.mapFrame(value, position, normalized);
+  }
 
-    int mapped = map(rawValue, minVal[finger], maxVal[finger], 0, ANALOG_MAX);
-    return constrain(mapped, 0, ANALOG_MAX);
+  // How the filter input relates to the ADC code (only used for linearization)
+  void setInputTransform(int finger, bool inverted, int offset) {
+    if (finger < 0 || finger >= SENSOR_COUNT) return;
+    positions.setInput(finger, inverted, offset);
+    positions.build(finger, minVal[finger], maxVal[finger]);
+  }
+
+  // Recompute the scale factors from minVal/maxVal
+  void rebuildMap() {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      positions.build(i, minVal[i], maxVal[i]);
+    }
   }
 
   void saveToEEPROM() {
     EEPROM.write(EEPROM_CAL_MAGIC_ADDR, EEPROM_CAL_MAGIC);
 
     int addr = EEPROM_CAL_DATA_ADDR;
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
       EEPROM.put(addr, minVal[i]);
       addr += sizeof(int);
       EEPROM.put(addr, maxVal[i]);
@@ -283,13 +305,14 @@ public:
     }
 
     int addr = EEPROM_CAL_DATA_ADDR;
-    for (int i = 0; i < 5; i++) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
       EEPROM.get(addr, minVal[i]);
       addr += sizeof(int);
       EEPROM.get(addr, maxVal[i]);
       addr += sizeof(int);
     }
     hasValidCalibration = true;
+    rebuildMap();
   }
 
   void clearEEPROM() {
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+// Serial command parsing without the heap
+//
+// feed() collects characters into a fixed buffer until CR or LF. The line
+// is then split in place into space-separated words (the command is
+// upper-cased, arguments are left as typed) and looked up in a table of
+// CommandDef entries. Lines longer than CMD_LINE_MAX are dropped whole
+// rather than run truncated.
+//
+// Table entries list their aliases separated by '|', e.g. "GESTURE|G".
+// The handler gets the words and the entry's `option`, so one handler can
+// serve several entries (all the mode switches, for instance).
+
+// ============ CONFIG ============
+#define CMD_LINE_MAX   64
+#define CMD_MAX_WORDS  4       // Command + up to 3 arguments
+
+struct CommandArgs {
+  uint8_t count;               // Words, including the command
+  char* word[CMD_MAX_WORDS];   // Point into the line buffer
+};
+
+typedef void (*CommandHandler)(const CommandArgs& args, int option);
+
+struct CommandDef {
+  const char* names;           // Aliases, '|'-separated, upper case
+  CommandHandler handler;
+  int option;
+};
+
+class CommandLine {
+private:
+  char line[CMD_LINE_MAX + 1];
+  uint8_t length;
+  bool overflow;
+
+  // True if `word` is one of the '|'-separated names
+  static bool matches(const char* names, const char* word) {
+    size_t n = strlen(word);
+    const char* p = names;
+    while (*p) {
+      const char* end = strchr(p, '|');
+      size_t len = end ? (size_t)(end - p) : strlen(p);
+      if (len == n && strncmp(p, word, n) == 0) return true;
+      if (!end) break;
+      p = end + 1;
+    }
+    return false;
+  }
+
+public:
+  CommandLine() : length(0), overflow(false) {
+    line[0] = 0;
+  }
+
+  // One received character; true when a complete line is ready
+  bool feed(char c) {
+    if (c == '\n' || c == '\r') {
+      bool ready = length > 0 && !overflow;
+      line[length] = 0;
+      if (!ready) length = 0;
+      overflow = false;
+      return ready;
+    }
+    if (length >= CMD_LINE_MAX) {
+      overflow = true;
+      length = 0;
+      return false;
+    }
+    if (!overflow) line[length++] = c;
+    return false;
+  }
+
+  // Split the ready line into words; the buffer is reused by the next feed()
+  CommandArgs parse() {
+    CommandArgs args;
+    args.count = 0;
+    char* p = line;
+    length = 0;
+    while (*p && args.count < CMD_MAX_WORDS) {
+      while (*p == ' ' || *p == '\t') *p++ = 0;
+      if (!*p) break;
+      args.word[args.count++] = p;
+      while (*p && *p != ' ' && *p != '\t') p++;
+    }
+    if (args.count > 0) {
+      for (char* c = args.word[0]; *c; c++) {
+        *c = toupper(*c);
+      }
+    }
+    return args;
+  }
+
+  // Run the table entry named by the first word; false if none matches
+  static bool dispatch(const CommandDef* table, size_t count, const CommandArgs& args) {
+    if (args.count == 0) return false;
+    for (size_t i = 0; i < count; i++) {
+      if (matches(table[i].names, args.word[0])) {
+        table[i].handler(args, table[i].option);
+        return true;
+      }
+    }
+    return false;
+  }
+};
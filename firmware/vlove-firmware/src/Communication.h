@@ -1,70 +1,133 @@
 #pragma once
 
 #include "Config.h"
+#include "Logger.h"
+#include "FingerFrame.h"
+
+#ifdef ENABLE_BLUETOOTH
 #include <BluetoothSerial.h>
+#endif
+
+#define COMM_LINE_MAX  192    // Longest protocol message
+#define COMM_TRACE_MAX 34     // "@<line>,<seq>,<us>" with three 32-bit numbers
+
+static_assert(COMM_LINE_MAX >= 2 + SENSOR_COUNT * 10, "R line with every channel must fit");
+
+// The frame a message comes from, for trace mode
+struct TraceStamp {
+  uint32_t seq;              // Frame number on its stream
+  uint32_t timestampUs;      // Capture time (device micros())
+};
 
 // Global mode variable
-OperationMode currentMode = MODE_HOME;
+OperationMode currentMode = BOOT_MODE;
 
 class Communication {
 private:
-  BluetoothSerial btSerial;
+#ifdef ENABLE_BLUETOOTH
+  BluetoothSerial btSerial;        // Stack starts on the first 'BT', not at boot
+#endif
   bool btEnabled = false;
   bool btConnected = false;
 
+  // Trace mode: every protocol message ends in @<line>,<seq>,<us>
+  //   line - messages sent since trace mode was turned on (gaps = lost on the link)
+  //   seq  - frame number on its stream (gaps = frames not sent)
+  //   us   - capture time of the frame's ADC sample, device micros()
+  // SYNC answers T,<micros()> so the host can line up the two clocks
+  bool trace = false;
+  uint32_t traceLines = 0;
+
 public:
   void begin() {
-    // Bluetooth is optional, start when requested
-    Serial.println("Communication initialized (Serial)");
-    Serial.println("Type 'BT' to enable Bluetooth");
+    logger.println("Communication initialized (Serial)");
+#ifdef ENABLE_BLUETOOTH
+    logger.println("Type 'BT' to enable Bluetooth");
+#endif
   }
 
   void toggleBluetooth() {
+#ifndef ENABLE_BLUETOOTH
+    logger.println("Bluetooth not in this build (ENABLE_BLUETOOTH)");
+#else
     if (!btEnabled) {
-      Serial.println("Starting Bluetooth...");
+      logger.println("Starting Bluetooth...");
       btSerial.begin(BT_DEVICE_NAME);
       btEnabled = true;
-      Serial.print("Bluetooth enabled: ");
-      Serial.println(BT_DEVICE_NAME);
+      logger.println("Bluetooth enabled: %s", BT_DEVICE_NAME);
     } else {
-      Serial.println("Stopping Bluetooth...");
+      logger.println("Stopping Bluetooth...");
       btSerial.end();
       btEnabled = false;
-      Serial.println("Bluetooth disabled");
+      logger.println("Bluetooth disabled");
     }
+#endif
   }
 
+  bool isBluetoothEnabled() const { return btEnabled; }
+
   bool isBluetoothConnected() {
-    if (!btEnabled) return false;
-    return btSerial.hasClient();
+#ifdef ENABLE_BLUETOOTH
+    if (btEnabled) return btSerial.hasClient();
+#endif
+    return false;
   }
 
   // Send to active output (Serial always, BT if connected)
   void send(const char* data) {
     Serial.print(data);
+#ifdef ENABLE_BLUETOOTH
     if (btEnabled && btSerial.hasClient()) {
       btSerial.print(data);
     }
+#endif
   }
 
-  void sendLine(const char* data) {
-    Serial.println(data);
+  void setTrace(bool on) {
+    trace = on;
+    traceLines = 0;
+  }
+
+  bool isTracing() const { return trace; }
+
+  // Clock sample for the host: T,<micros>
+  void sendSync() {
+    char buffer[16];
+    sprintf(buffer, "T,%lu", (unsigned long)micros());
+    sendLine(buffer);
+  }
+
+  // One write per line, so the log task can't split a message
+  // With a stamp, trace mode appends it
+  void sendLine(const char* data, const TraceStamp* stamp = nullptr) {
+    char line[COMM_LINE_MAX + COMM_TRACE_MAX + 2];
+    size_t n = strnlen(data, COMM_LINE_MAX);
+    memcpy(line, data, n);
+    if (trace && stamp) {
+      n += sprintf(line + n, "@%lu,%lu,%lu", (unsigned long)++traceLines,
+                   (unsigned long)stamp->seq, (unsigned long)stamp->timestampUs);
+    }
+    line[n++] = '\r';
+    line[n++] = '\n';
+    Serial.write((const uint8_t*)line, n);
+#ifdef ENABLE_BLUETOOTH
     if (btEnabled && btSerial.hasClient()) {
-      btSerial.println(data);
+      btSerial.write((const uint8_t*)line, n);
     }
+#endif
   }
 
   // Send gesture event
   // Format: G,<gesture_id>,<gesture_name>
-  void sendGesture(int gestureId, const char* gestureName) {
+  void sendGesture(int gestureId, const char* gestureName, const TraceStamp* stamp = nullptr) {
     char buffer[64];
     sprintf(buffer, "G,%d,%s", gestureId, gestureName);
-    sendLine(buffer);
+    sendLine(buffer, stamp);
   }
 
   // Send piano event
   // Format: P,<type>,<note>,<velocity>,<pitchbend>,<chord_notes...>
-  void sendPianoEvent(PianoEvent& event) {
+  void sendPianoEvent(const PianoEvent& event, const TraceStamp* stamp = nullptr) {
     char buffer[64];
 
     switch (event.type) {
@@ -106,17 +169,22 @@ public:
         return;
     }
 
-    sendLine(buffer);
+    sendLine(buffer, stamp);
   }
 
-  // Send raw data
+  // Send raw data, every sensor channel
   // Format: R,<raw0>,<raw1>,...,<mapped0>,<mapped1>,...
-  void sendRawData(int raw[5], int mapped[5]) {
-    char buffer[128];
-    sprintf(buffer, "R,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d",
-            raw[0], raw[1], raw[2], raw[3], raw[4],
-            mapped[0], mapped[1], mapped[2], mapped[3], mapped[4]);
-    sendLine(buffer);
+  void sendRawData(const FingerFrame& frame) {
+    char buffer[COMM_LINE_MAX + 1];
+    int n = sprintf(buffer, "R");
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      n += sprintf(buffer + n, ",%d", frame.raw[i]);
+    }
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      n += sprintf(buffer + n, ",%d", frame.position[i]);
+    }
+    TraceStamp stamp = {frame.seq, frame.timestampUs};
+    sendLine(buffer, &stamp);
   }
 
   // ============ OPENGLOVES PROTOCOL ============
@@ -124,28 +192,28 @@ public:
   // Format: A<thumb>B<index>C<middle>D<ring>E<pinky>\n
   // With IMU: A<thumb>B<index>C<middle>D<ring>E<pinky>(w|x|y|z)\n
 
-  // Send finger data only (no IMU)
-  void sendOpenGloves(int fingers[5]) {
-    char buffer[64];
-    sprintf(buffer, "A%dB%dC%dD%dE%d",
-            fingers[0], fingers[1], fingers[2], fingers[3], fingers[4]);
-    sendLine(buffer);
-  }
-
-  // Send finger data with IMU quaternion
-  void sendOpenGlovesWithIMU(int fingers[5], float qw, float qx, float qy, float qz) {
+  // Send the finger curls, plus the hand orientation if the frame has one
+  void sendOpenGloves(const FingerFrame& frame) {
     char buffer[128];
-    // OpenGloves expects quaternion in parentheses, pipe-separated
-    // Format: A<thumb>B<index>C<middle>D<ring>E<pinky>(qw|qx|qy|qz)
-    sprintf(buffer, "A%dB%dC%dD%dE%d(%.4f|%.4f|%.4f|%.4f)",
-            fingers[0], fingers[1], fingers[2], fingers[3], fingers[4],
-            qw, qx, qy, qz);
-    sendLine(buffer);
+    const int16_t* fingers = frame.position;
+    int n = sprintf(buffer, "A%dB%dC%dD%dE%d",
+                    fingers[0], fingers[1], fingers[2], fingers[3], fingers[4]);
+#ifdef ENABLE_IMU
+    if (frame.hasOrientation) {
+      // OpenGloves expects quaternion in parentheses, pipe-separated
+      const Quaternion& q = frame.orientation;
+      sprintf(buffer + n, "(%.4f|%.4f|%.4f|%.4f)", q.w, q.x, q.y, q.z);
+    }
+#else
+    (void)n;
+#endif
+    TraceStamp stamp = {frame.seq, frame.timestampUs};
+    sendLine(buffer, &stamp);
   }
 
   // Send full OpenGloves data with splay (optional)
   // F-J are splay values for each finger
-  void sendOpenGlovesFull(int curl[5], int splay[5], float qw, float qx, float qy, float qz) {
+  void sendOpenGlovesFull(const int curl[FINGER_COUNT], const int splay[FINGER_COUNT], float qw, float qx, float qy, float qz) {
     char buffer[160];
     sprintf(buffer, "A%dB%dC%dD%dE%dF%dG%dH%dI%dJ%d(%.4f|%.4f|%.4f|%.4f)",
             curl[0], curl[1], curl[2], curl[3], curl[4],
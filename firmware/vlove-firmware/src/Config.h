@@ -2,10 +2,57 @@
 
 #include <Arduino.h>
 
+// ============ BUILD PROFILE ============
+// Pick one to leave out what a unit never uses (default: FULL).
+// Profiles set the feature toggles below and the filter profile (see
+// AnalogFilter.h); BUILD prints the resulting size, RAM and boot time.
+//   VLOVE_PROFILE_GESTURE     - gesture recognition; boots into G
+//   VLOVE_PROFILE_PIANO       - air piano; boots into P1
+//   VLOVE_PROFILE_OPENGLOVES  - SteamVR over USB; boots into VR, no Bluetooth,
+//                               One-Euro filter only, short console text
+//   VLOVE_PROFILE_FULL        - everything, modes switched at runtime
+// #define VLOVE_PROFILE_OPENGLOVES
+#if !defined(VLOVE_PROFILE_GESTURE) && !defined(VLOVE_PROFILE_PIANO) && \
+    !defined(VLOVE_PROFILE_OPENGLOVES) && !defined(VLOVE_PROFILE_FULL)
+#define VLOVE_PROFILE_FULL
+#endif
+
+#if defined(VLOVE_PROFILE_GESTURE)
+#define VLOVE_PROFILE_NAME  "gesture"
+#define BOOT_MODE           MODE_GESTURE
+#define ENABLE_GESTURES
+#define FILTER_PROFILE_GESTURE
+#elif defined(VLOVE_PROFILE_PIANO)
+#define VLOVE_PROFILE_NAME  "piano"
+#define BOOT_MODE           MODE_PIANO_SINGLE
+#define ENABLE_PIANO
+#define FILTER_PROFILE_PIANO
+#elif defined(VLOVE_PROFILE_OPENGLOVES)
+#define VLOVE_PROFILE_NAME  "opengloves"
+#define BOOT_MODE           MODE_OPENGLOVES
+#define ENABLE_OPENGLOVES
+#define FILTER_PROFILE_OPENGLOVES
+#else
+#define VLOVE_PROFILE_NAME  "full"
+#define BOOT_MODE           MODE_HOME
+#define ENABLE_GESTURES         // Static + dynamic gesture recognition
+#define ENABLE_PIANO            // Air piano modes
+#define ENABLE_OPENGLOVES       // OpenGloves protocol for SteamVR
+#endif
+
+#ifndef VLOVE_PROFILE_OPENGLOVES
+#define ENABLE_BLUETOOTH        // Bluetooth serial (links the BT stack and keeps its controller RAM)
+#define ENABLE_HELP_TEXT        // Banner, full help and calibration instructions
+#endif
+
 // ============ FEATURE TOGGLES ============
 // Comment out to disable features
 // #define ENABLE_IMU           // MPU6050 IMU support (requires external MPU6050 module)
-#define ENABLE_OPENGLOVES       // OpenGloves protocol for SteamVR
+#define ENABLE_ADC_ENGINE       // Sample all fingers at a fixed rate (continuous DMA ADC on Arduino-ESP32 3.x, esp_timer otherwise)
+#define ENABLE_DUAL_CORE        // Acquisition + filtering in a task on core 0, gestures/piano/output in loop() on core 1
+#define ENABLE_POWER_SAVE       // Clock down and idle with light sleep when the mode allows it (see PowerScheduler.h)
+#define ENABLE_FAST_BOOT        // First frame right after reset: no startup delay or warm-up, stored IMU offsets, banner later
+// #define ENABLE_PROFILER      // Cycle counts per pipeline stage (STATS); compiled out when off
 
 // ============ PIN CONFIGURATION ============
 // ESP32 DOIT V1 pins
@@ -33,7 +80,8 @@
 #define COMM_BLUETOOTH    1
 
 // ============ TIMING ============
-#define LOOP_DELAY_MS     10
+#define LOOP_DELAY_MS     10    // Loop pacing without ENABLE_ADC_ENGINE (frames are timer-driven with it)
+#define FAST_BOOT_QUIET_MS  500   // ENABLE_FAST_BOOT: banner/help once frames flow, or after this long
 
 // ============ ADC ============
 #define ANALOG_MAX        4095
@@ -47,6 +95,25 @@
 #define INVERT_RING    true
 #define INVERT_PINKY   true
 
+// ============ SENSORS ============
+// Channel order of every frame: the finger curls first (thumb to pinky),
+// then any extra sensors (splay, joints). The ADC, filters, calibration and
+// motion features run on all SENSOR_COUNT channels; finger-level consumers
+// (gestures, piano, OpenGloves curls) read the first FINGER_COUNT.
+// Add a pin, polarity and 6-character name per extra sensor. The ESP32 has
+// 8 usable ADC1 pins; beyond that needs an external multiplexer.
+#define FINGER_COUNT   5
+#define SENSOR_COUNT   5
+
+static const uint8_t SENSOR_PINS[] = {PIN_THUMB, PIN_INDEX, PIN_MIDDLE, PIN_RING, PIN_PINKY};
+static const bool SENSOR_INVERTED[] = {INVERT_THUMB, INVERT_INDEX, INVERT_MIDDLE, INVERT_RING, INVERT_PINKY};
+static const char* const SENSOR_NAMES[] = {"Thumb ", "Index ", "Middle", "Ring  ", "Pinky "};
+
+static_assert(SENSOR_COUNT >= FINGER_COUNT, "finger curls are the first channels");
+static_assert(sizeof(SENSOR_PINS) == SENSOR_COUNT, "one pin per sensor");
+static_assert(sizeof(SENSOR_INVERTED) == SENSOR_COUNT, "one polarity per sensor");
+static_assert(sizeof(SENSOR_NAMES) / sizeof(SENSOR_NAMES[0]) == SENSOR_COUNT, "one name per sensor");
+
 // ============ OPENGLOVES CONFIG ============
 // Alpha encoding character mapping
 // A-E: finger curl (0-4095 mapped to 0-4095)
@@ -124,7 +191,7 @@ struct PianoEvent {
   uint8_t note;       // MIDI note number (0-127)
   uint8_t velocity;   // 0-127
   int16_t pitchBend;  // -8192 to 8191
-  uint8_t chord[5];   // Up to 5 notes in a chord
+  uint8_t chord[FINGER_COUNT];   // Up to one note per finger
   uint8_t chordSize;
 };
 
@@ -139,7 +206,9 @@ struct PianoEvent {
 #define EEPROM_SIZE           512
 #define EEPROM_CAL_MAGIC_ADDR 0x00
 #define EEPROM_CAL_DATA_ADDR  0x01
-#define EEPROM_CAL_MAGIC      0xCA
+#define EEPROM_CAL_MAGIC      (0xCA + SENSOR_COUNT - FINGER_COUNT)  // Per channel count: another layout reads as uncalibrated
+
+static_assert(EEPROM_CAL_DATA_ADDR + SENSOR_COUNT * 2 * sizeof(int) <= EEPROM_SIZE, "calibration does not fit EEPROM_SIZE");
 
 // ============ GESTURE THRESHOLDS ============
 // Finger position thresholds (0-4095 scale after calibration)
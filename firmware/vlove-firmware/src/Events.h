@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+#include "Config.h"
+
+// Recognition events
+//
+// GestureRecognizer and AirPiano publish what changed (a gesture began or
+// ended, a dynamic gesture completed, a note started or stopped) to the
+// sinks subscribed here. A frame that changes nothing publishes nothing, so
+// transports and logging cost no work per frame. Sinks run synchronously
+// on the publisher's thread (loop()), in subscription order; the event is
+// only valid during the call. The sink table is fixed; nothing is allocated.
+
+// ============ CONFIG ============
+#define EVENT_MAX_SINKS  4
+
+enum GloveEventType : uint8_t {
+  EVENT_STATIC_BEGIN = 0,   // gesture, confidence
+  EVENT_STATIC_END,         // gesture (the one that ended)
+  EVENT_DYNAMIC,            // gesture (completed)
+  EVENT_NOTE_ON,            // piano (single note or chord)
+  EVENT_NOTE_OFF,           // piano
+  EVENT_PITCH_BEND,         // piano
+  EVENT_TYPE_COUNT
+};
+
+#define EVENT_BIT(type)   (1 << (type))
+#define EVENTS_GESTURE    (EVENT_BIT(EVENT_STATIC_BEGIN) | EVENT_BIT(EVENT_STATIC_END) | EVENT_BIT(EVENT_DYNAMIC))
+#define EVENTS_PIANO      (EVENT_BIT(EVENT_NOTE_ON) | EVENT_BIT(EVENT_NOTE_OFF) | EVENT_BIT(EVENT_PITCH_BEND))
+#define EVENTS_ALL        (EVENTS_GESTURE | EVENTS_PIANO)
+
+struct GloveEvent {
+  GloveEventType type;
+  uint8_t gesture;          // GestureId (gesture events)
+  uint8_t confidence;       // 0-100 (EVENT_STATIC_BEGIN)
+  uint32_t timestampUs;     // Capture time of the frame that caused it (0 = unknown)
+  uint32_t seq;             // Its frame number on its stream
+  PianoEvent piano;         // Note events
+};
+
+typedef void (*EventSink)(const GloveEvent& event, void* arg);
+
+class EventBus {
+private:
+  struct Subscriber {
+    EventSink sink;
+    void* arg;
+    uint8_t mask;           // EVENT_BIT set of the types it gets
+  };
+
+  Subscriber subscribers[EVENT_MAX_SINKS];
+  uint8_t count;
+
+public:
+  EventBus() : count(0) {}
+
+  // False if all EVENT_MAX_SINKS slots are taken
+  bool subscribe(EventSink sink, void* arg = nullptr, uint8_t mask = EVENTS_ALL) {
+    if (count >= EVENT_MAX_SINKS || !sink) return false;
+    subscribers[count].sink = sink;
+    subscribers[count].arg = arg;
+    subscribers[count].mask = mask;
+    count++;
+    return true;
+  }
+
+  bool unsubscribe(EventSink sink, void* arg = nullptr) {
+    for (int i = 0; i < count; i++) {
+      if (subscribers[i].sink == sink && subscribers[i].arg == arg) {
+        for (int j = i + 1; j < count; j++) {
+          subscribers[j - 1] = subscribers[j];
+        }
+        count--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  uint8_t sinkCount() const { return count; }
+
+  void publish(const GloveEvent& event) const {
+    for (int i = 0; i < count; i++) {
+      if (subscribers[i].mask & EVENT_BIT(event.type)) {
+        subscribers[i].sink(event, subscribers[i].arg);
+      }
+    }
+  }
+};
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <stdint.h>
+#include "Config.h"
+
+// Sliding-window features per finger, O(1) per sample
+//
+// One shared history so consumers don't each keep their own buffers:
+//   velocity / acceleration - first / second difference over FEATURE_SLOPE_MS
+//   mean / variance         - running sum and sum of squares over the window
+//   min / max               - monotonic queues (amortized O(1), Lemire)
+//   still                   - max - min inside FEATURE_STILL_RANGE
+// Sums are exact integers, so nothing drifts however long it runs. Windows
+// are set in milliseconds and converted to samples for the stream rate.
+// Positions are calibrated counts (0-ANALOG_MAX), speeds counts/s.
+//
+// State is structure-of-arrays over SENSOR_COUNT channels: one history row
+// holds a frame, and the running sums sit side by side, so update() sweeps
+// each array once per frame. Only the extreme queues stay per channel, as
+// their lengths differ.
+
+// ============ CONFIG ============
+#define FEATURE_MAX_WINDOW   256   // History per channel in samples (power of two)
+#define FEATURE_WINDOW_MS    200   // Mean / variance / min / max window
+#define FEATURE_SLOPE_MS     20    // Difference span for velocity and acceleration
+#define FEATURE_STILL_RANGE  60    // counts, peak-to-peak below this = finger still
+
+// All channels at one stream rate
+class FingerFeatures {
+  static const uint32_t MASK = FEATURE_MAX_WINDOW - 1;
+  static_assert((FEATURE_MAX_WINDOW & MASK) == 0, "FEATURE_MAX_WINDOW must be a power of two");
+
+private:
+  int16_t history[FEATURE_MAX_WINDOW][SENSOR_COUNT];
+  int32_t sum[SENSOR_COUNT];
+  uint64_t sumSq[SENSOR_COUNT];
+  uint32_t count;          // Frames since reset (sequence of the next frame)
+  uint16_t window;         // Frames in mean / variance / min / max
+  uint16_t lag;            // Frames between difference points
+  uint16_t rateHz;
+
+  // Sequence numbers (low 16 bits) of candidate extremes, oldest first
+  uint16_t maxQueue[SENSOR_COUNT][FEATURE_MAX_WINDOW];
+  uint16_t minQueue[SENSOR_COUNT][FEATURE_MAX_WINDOW];
+  uint32_t maxHead[SENSOR_COUNT], maxTail[SENSOR_COUNT];
+  uint32_t minHead[SENSOR_COUNT], minTail[SENSOR_COUNT];
+
+  int at(uint32_t seq, int ch) const { return history[seq & MASK][ch]; }
+
+  // Add frame seq to one channel's extreme queue (sign 1 = max, -1 = min)
+  void pushExtreme(uint16_t* queue, uint32_t& headRef, uint32_t& tailRef,
+                   uint32_t seq, int ch, int x, int sign) {
+    uint32_t head = headRef, tail = tailRef;
+    if (head != tail && (uint16_t)(seq - queue[head & MASK]) >= window) head++;
+
+    // Newer samples that are at least as extreme make older ones irrelevant
+    while (head != tail && sign * at(queue[(tail - 1) & MASK], ch) <= sign * x) tail--;
+    queue[tail++ & MASK] = (uint16_t)seq;
+    headRef = head;
+    tailRef = tail;
+  }
+
+  // Window and lag in frames; lag is limited so acceleration's 2 * lag fits
+  void configure(uint16_t windowFrames, uint16_t lagFrames) {
+    if (windowFrames < 1) windowFrames = 1;
+    if (windowFrames > FEATURE_MAX_WINDOW) windowFrames = FEATURE_MAX_WINDOW;
+    if (lagFrames < 1) lagFrames = 1;
+    if (lagFrames > FEATURE_MAX_WINDOW / 2 - 1) lagFrames = FEATURE_MAX_WINDOW / 2 - 1;
+    window = windowFrames;
+    lag = lagFrames;
+    reset();
+  }
+
+public:
+  FingerFeatures() : window(1), lag(1), rateHz(0) {
+    reset();
+    setRate(100);
+  }
+
+  // Convert the configured windows to frames; history restarts
+  void setRate(uint16_t hz) {
+    if (hz == 0 || hz == rateHz) return;
+    rateHz = hz;
+    configure((uint16_t)((uint32_t)FEATURE_WINDOW_MS * hz / 1000),
+              (uint16_t)((uint32_t)FEATURE_SLOPE_MS * hz / 1000));
+  }
+
+  uint16_t getRate() const { return rateHz; }
+
+  void update(const int16_t values[SENSOR_COUNT]) {
+    uint32_t seq = count;
+    int16_t* row = history[seq & MASK];
+
+    // Drop the frame leaving the window before its row is reused
+    if (seq >= window) {
+      const int16_t* old = history[(seq - window) & MASK];
+      for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+        sum[ch] -= old[ch];
+        sumSq[ch] -= (uint32_t)(old[ch] * old[ch]);
+      }
+    }
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      int x = values[ch];
+      row[ch] = (int16_t)x;
+      sum[ch] += x;
+      sumSq[ch] += (uint32_t)(x * x);
+    }
+
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      int x = values[ch];
+      pushExtreme(maxQueue[ch], maxHead[ch], maxTail[ch], seq, ch, x, 1);
+      pushExtreme(minQueue[ch], minHead[ch], minTail[ch], seq, ch, x, -1);
+    }
+
+    count++;
+  }
+
+  void reset() {
+    count = 0;
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      sum[ch] = 0;
+      sumSq[ch] = 0;
+      maxHead[ch] = maxTail[ch] = 0;
+      minHead[ch] = minTail[ch] = 0;
+    }
+  }
+
+  // Frames currently in the window
+  uint16_t size() const { return count < window ? count : window; }
+  bool isFull() const { return count >= window; }
+
+  int getLatest(int ch) const { return count ? at(count - 1, ch) : 0; }
+  int getMin(int ch) const { return count ? at(minQueue[ch][minHead[ch] & MASK], ch) : 0; }
+  int getMax(int ch) const { return count ? at(maxQueue[ch][maxHead[ch] & MASK], ch) : 0; }
+
+  float getMean(int ch) const {
+    uint16_t n = size();
+    return n ? (float)sum[ch] / n : 0;
+  }
+
+  float getVariance(int ch) const {
+    uint16_t n = size();
+    if (n < 2) return 0;
+    // n * sumSq - sum^2 is exact in 64 bits; float only for the final divide
+    int64_t scaled = (int64_t)(n * sumSq[ch]) - (int64_t)sum[ch] * sum[ch];
+    return (float)scaled / ((float)n * n);
+  }
+
+  // counts/s, positive = closing
+  float getVelocity(int ch) const {
+    if (count <= lag) return 0;
+    return (float)(at(count - 1, ch) - at(count - 1 - lag, ch)) / lag * rateHz;
+  }
+
+  // counts/s^2
+  float getAcceleration(int ch) const {
+    if (count <= 2u * lag) return 0;
+    int d2 = at(count - 1, ch) - 2 * at(count - 1 - lag, ch) + at(count - 1 - 2 * lag, ch);
+    return (float)d2 / ((float)lag * lag) * rateHz * rateHz;
+  }
+
+  // Channel hasn't moved more than FEATURE_STILL_RANGE over a full window
+  bool isStill(int ch) const {
+    return isFull() && getMax(ch) - getMin(ch) <= FEATURE_STILL_RANGE;
+  }
+
+  // Whole hand still
+  bool isQuiescent() const {
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      if (!isStill(ch)) return false;
+    }
+    return true;
+  }
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include "Config.h"
+
+#ifdef ENABLE_IMU
+#include "IMU.h"
+#endif
+
+// One frame as every consumer sees it
+//
+// Built once per published frame of a stream (nextFrame() in the sketch)
+// from the filtered values. PositionMap::mapFrame() gives the calibrated
+// position with a subtract, a Q16 multiply and a shift per channel, and the
+// 0-255 position from that with one more multiply by CAL_NORM_Q16, so
+// matchers compare bytes and nobody rescales. Consumers get it by const
+// reference and share its capture time and sequence number.
+//
+// Values are 12-bit, so they are stored as int16_t to keep the frame small
+// (cheap to copy and to cache per stream).
+
+struct FingerFrame {
+  uint32_t timestampUs;              // Capture time of the sample
+  uint32_t seq;                      // Frame number on its stream (gaps = frames skipped)
+  uint16_t intervalMs;               // Capture time since the previous frame of this stream
+  uint8_t stream;                    // SampleStream it came from
+#ifdef ENABLE_IMU
+  bool hasOrientation;               // orientation is set (OpenGloves with the IMU on)
+  Quaternion orientation;
+#endif
+  int16_t raw[SENSOR_COUNT];         // Filtered, not calibrated (0-ANALOG_MAX)
+  int16_t position[SENSOR_COUNT];    // Calibrated (0-ANALOG_MAX)
+  int16_t onset[FINGER_COUNT];       // Calibrated fast onset path (note triggers)
+  uint8_t normalized[SENSOR_COUNT];  // Calibrated, 0-255 gesture scale
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+#ifdef ESP32
+#include <esp_timer.h>
+#endif
+
+// Periodic frame clock for the ADC sampler
+//
+//   EspFrameTimer       - esp_timer periodic callback. Runs in the esp_timer
+//                         task (analogRead() is allowed there), so frame
+//                         timing doesn't depend on how long loop() takes.
+//   SimulatedFrameTimer - virtual clock for host builds. advance() fires
+//                         every tick that falls in the elapsed time, so runs
+//                         are exact and repeatable.
+//
+// Both provide:
+//   bool begin(uint32_t periodUs, FrameTick callback, void* arg)
+//   void stop()
+//   uint32_t now() const   -> current time in microseconds
+
+typedef void (*FrameTick)(void* arg);
+
+#ifdef ESP32
+class EspFrameTimer {
+private:
+  esp_timer_handle_t handle;
+
+public:
+  EspFrameTimer() : handle(nullptr) {}
+
+  bool begin(uint32_t periodUs, FrameTick callback, void* arg) {
+    esp_timer_create_args_t args = {};
+    args.callback = callback;
+    args.arg = arg;
+    args.dispatch_method = ESP_TIMER_TASK;
+    args.name = "adc_frame";
+
+    if (esp_timer_create(&args, &handle) != ESP_OK) return false;
+    return esp_timer_start_periodic(handle, periodUs) == ESP_OK;
+  }
+
+  void stop() {
+    if (!handle) return;
+    esp_timer_stop(handle);
+    esp_timer_delete(handle);
+    handle = nullptr;
+  }
+
+  uint32_t now() const { return (uint32_t)esp_timer_get_time(); }
+};
+#endif
+
+class SimulatedFrameTimer {
+private:
+  FrameTick callback;
+  void* arg;
+  uint32_t periodUs;
+  uint32_t nowUs;
+  uint32_t nextTickUs;
+  bool running;
+
+public:
+  SimulatedFrameTimer()
+    : callback(nullptr), arg(nullptr), periodUs(1000), nowUs(0), nextTickUs(0), running(false) {}
+
+  bool begin(uint32_t period, FrameTick cb, void* cbArg) {
+    callback = cb;
+    arg = cbArg;
+    periodUs = period;
+    nextTickUs = nowUs + period;
+    running = true;
+    return true;
+  }
+
+  void stop() { running = false; }
+
+  // Let simulated time run forward, firing each tick at its exact time
+  void advance(uint32_t us) {
+    uint32_t target = nowUs + us;
+    while (running && (int32_t)(target - nextTickUs) >= 0) {
+      nowUs = nextTickUs;
+      nextTickUs += periodUs;
+      callback(arg);
+    }
+    nowUs = target;
+  }
+
+  uint32_t now() const { return nowUs; }
+};
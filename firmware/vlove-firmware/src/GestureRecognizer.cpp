@@ -1,10 +1,13 @@
 #include "GestureRecognizer.h"
 
 GestureRecognizer::GestureRecognizer()
-    : lastStaticGesture(GESTURE_NONE)
+    : events(nullptr)
+    , lastStaticGesture(GESTURE_NONE)
     , lastDynamicGesture(GESTURE_NONE)
     , lastConfidence(0)
-    , initialized(false) {
+    , initialized(false)
+    , scoreConfidence(true)
+    , trackDynamic(true) {
 }
 
 void GestureRecognizer::begin() {
@@ -19,6 +22,14 @@ void GestureRecognizer::begin() {
     initialized = true;
 }
 
+void GestureRecognizer::setDynamicEnabled(bool enabled) {
+    // Resume from a clean state machine, not phases left from before the pause
+    if (enabled && !trackDynamic) {
+        dynamicMatcher.reset();
+    }
+    trackDynamic = enabled;
+}
+
 void GestureRecognizer::reset() {
     staticMatcher.reset();
     dynamicMatcher.reset();
@@ -27,7 +38,31 @@ void GestureRecognizer::reset() {
     lastConfidence = 0;
 }
 
-GestureResult GestureRecognizer::recognizeEx(int fingers[5], uint16_t deltaTimeMs) {
+GestureResult GestureRecognizer::recognizeEx(int fingers[NUM_FINGERS], uint16_t deltaTimeMs) {
+    FingerPos positions[NUM_FINGERS];
+    for (int i = 0; i < NUM_FINGERS; i++) {
+        positions[i] = normalizeFingerPos(fingers[i]);
+    }
+    return recognizePositions(positions, deltaTimeMs, 0, 0);
+}
+
+GestureResult GestureRecognizer::recognizeEx(const FingerFrame& frame) {
+    return recognizePositions(frame.normalized, frame.intervalMs, frame.timestampUs, frame.seq);
+}
+
+void GestureRecognizer::publish(GloveEventType type, GestureId gesture, uint8_t confidence,
+                                uint32_t timestampUs, uint32_t seq) {
+    GloveEvent event = {};
+    event.type = type;
+    event.gesture = gesture;
+    event.confidence = confidence;
+    event.timestampUs = timestampUs;
+    event.seq = seq;
+    events->publish(event);
+}
+
+GestureResult GestureRecognizer::recognizePositions(const FingerPos* positions, uint16_t deltaTimeMs,
+                                                    uint32_t timestampUs, uint32_t seq) {
     GestureResult result;
     result.staticGesture = GESTURE_NONE;
     result.dynamicGesture = GESTURE_NONE;
@@ -41,34 +76,46 @@ GestureResult GestureRecognizer::recognizeEx(int fingers[5], uint16_t deltaTimeM
 
     // Match static gestures
     uint8_t confidence = 0;
-    GestureId staticGesture = staticMatcher.match(fingers, &confidence);
+    GestureId staticGesture = staticMatcher.match(positions, scoreConfidence ? &confidence : nullptr);
 
     if (staticGesture != GESTURE_NONE) {
         result.staticGesture = staticGesture;
         result.confidence = confidence;
         result.isNewStatic = (staticGesture != lastStaticGesture);
+        if (result.isNewStatic && events) {
+            if (lastStaticGesture != GESTURE_NONE) {
+                publish(EVENT_STATIC_END, lastStaticGesture, 0, timestampUs, seq);
+            }
+            publish(EVENT_STATIC_BEGIN, staticGesture, confidence, timestampUs, seq);
+        }
         lastStaticGesture = staticGesture;
         lastConfidence = confidence;
     } else if (lastStaticGesture != GESTURE_NONE) {
         // Gesture ended
         result.isNewStatic = true;
+        if (events) {
+            publish(EVENT_STATIC_END, lastStaticGesture, 0, timestampUs, seq);
+        }
         lastStaticGesture = GESTURE_NONE;
         lastConfidence = 0;
     }
 
     // Update dynamic gesture matcher
-    GestureId dynamicGesture = dynamicMatcher.update(fingers, deltaTimeMs);
+    GestureId dynamicGesture = trackDynamic ? dynamicMatcher.update(positions, deltaTimeMs) : GESTURE_NONE;
 
     if (dynamicGesture != GESTURE_NONE) {
         result.dynamicGesture = dynamicGesture;
         result.isNewDynamic = true;
         lastDynamicGesture = dynamicGesture;
+        if (events) {
+            publish(EVENT_DYNAMIC, dynamicGesture, 0, timestampUs, seq);
+        }
     }
 
     return result;
 }
 
-int GestureRecognizer::recognize(int fingers[5]) {
+int GestureRecognizer::recognize(int fingers[NUM_FINGERS]) {
     // Backward compatible interface - just return static gesture
     GestureResult result = recognizeEx(fingers, 10);
     return result.staticGesture;
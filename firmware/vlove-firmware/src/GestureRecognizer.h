@@ -1,11 +1,16 @@
 #pragma once
 
 #include "Config.h"
+#include "FingerFrame.h"
+#include "Events.h"
 #include "gesture/GestureTypes.h"
 #include "gesture/StaticMatcher.h"
 #include "gesture/DynamicMatcher.h"
 #include "gesture/GestureLib.h"
 
+// Gesture definitions constrain the finger curls, the first channels of a frame
+static_assert(NUM_FINGERS == FINGER_COUNT, "gesture tables are written for FINGER_COUNT fingers");
+
 class GestureRecognizer {
 public:
     GestureRecognizer();
@@ -15,11 +20,14 @@ public:
 
     // Main recognition function (backward compatible)
     // Returns gesture ID using the legacy recognize() interface
-    int recognize(int fingers[5]);
+    int recognize(int fingers[NUM_FINGERS]);
 
     // Extended recognition function
     // Returns full GestureResult with static, dynamic, and confidence
-    GestureResult recognizeEx(int fingers[5], uint16_t deltaTimeMs = 10);
+    GestureResult recognizeEx(int fingers[NUM_FINGERS], uint16_t deltaTimeMs = 10);
+
+    // Same on a pipeline frame: its 0-255 positions and frame interval
+    GestureResult recognizeEx(const FingerFrame& frame);
 
     // Get gesture name (backward compatible)
     const char* getGestureName(int gesture);
@@ -38,20 +46,36 @@ public:
         return dynamicMatcher.registerGesture(header, phases);
     }
 
-    // Reset all tracking state
+    // Publish static begin/end and dynamic completions to `bus` (nullptr = off)
+    void setEventBus(EventBus* bus) { events = bus; }
+
+    // Reset all tracking state (a held gesture is dropped without an end event)
     void reset();
 
+    // Optional work that can be shed under load (see Qos.h)
+    // Without confidence scoring, equal-priority ties go to the first match
+    void setConfidenceEnabled(bool enabled) { scoreConfidence = enabled; }
+    void setDynamicEnabled(bool enabled);
+
     // Get last recognized gestures
     GestureId getLastStaticGesture() const { return lastStaticGesture; }
     GestureId getLastDynamicGesture() const { return lastDynamicGesture; }
     uint8_t getLastConfidence() const { return lastConfidence; }
 
 private:
+    GestureResult recognizePositions(const FingerPos* positions, uint16_t deltaTimeMs,
+                                     uint32_t timestampUs, uint32_t seq);
+    void publish(GloveEventType type, GestureId gesture, uint8_t confidence,
+                 uint32_t timestampUs, uint32_t seq);
+
     StaticMatcher staticMatcher;
     DynamicMatcher dynamicMatcher;
+    EventBus* events;
 
     GestureId lastStaticGesture;
     GestureId lastDynamicGesture;
     uint8_t lastConfidence;
     bool initialized;
+    bool scoreConfidence;
+    bool trackDynamic;
 };
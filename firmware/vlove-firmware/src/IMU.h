@@ -2,6 +2,11 @@
 
 #include <Arduino.h>
 #include <Wire.h>
+#include "Logger.h"
+
+#ifdef ESP32
+#include <Preferences.h>
+#endif
 
 // MPU6050 registers
 #define MPU6050_ADDR         0x68
@@ -13,6 +18,13 @@
 #define MPU6050_ACCEL_XOUT_H 0x3B
 #define MPU6050_GYRO_XOUT_H  0x43
 
+// Startup and gyro bias tracking
+#define IMU_STARTUP_MS       35       // Gyro start-up time after wake (30 ms typ.); update() waits it out
+#define IMU_STILL_DPS        3.0f     // Corrected rate below this on every axis = still
+#define IMU_STILL_G          0.05f    // ...and accel magnitude within this of 1 g
+#define IMU_BIAS_ALPHA       0.002f   // Per still sample (~5 s time constant at 100 Hz)
+#define IMU_NVS_NAMESPACE    "imu"
+
 // Quaternion structure
 struct Quaternion {
     float w, x, y, z;
@@ -39,6 +51,12 @@ private:
     int16_t gyroOffset[3] = {0, 0, 0};
     int16_t accelOffset[3] = {0, 0, 0};
 
+    // Gyro bias refined while the hand is still (LSB)
+    float gyroBias[3] = {0, 0, 0};
+    bool trackBias = true;
+    unsigned long wakeUs = 0;        // When the sensor was woken
+    mutable bool settled = false;    // Start-up time has passed since wakeUs (latched)
+
     // Processed data
     float accel[3];  // g
     float gyro[3];   // deg/s
@@ -139,6 +157,19 @@ private:
         quat.z = q3 / norm;
     }
 
+    // Nudge the gyro offsets toward the raw reading while nothing moves
+    void updateBias() {
+        float g2 = accel[0] * accel[0] + accel[1] * accel[1] + accel[2] * accel[2];
+        if (fabs(g2 - 1.0f) > 2.0f * IMU_STILL_G) return;
+        for (int j = 0; j < 3; j++) {
+            if (fabs(gyro[j]) > IMU_STILL_DPS) return;
+        }
+        for (int j = 0; j < 3; j++) {
+            gyroBias[j] += (gyroRaw[j] - gyroBias[j]) * IMU_BIAS_ALPHA;
+            gyroOffset[j] = (int16_t)lroundf(gyroBias[j]);
+        }
+    }
+
     void quaternionToEuler() {
         // Roll (x-axis rotation)
         float sinr_cosp = 2.0f * (quat.w * quat.x + quat.y * quat.z);
@@ -166,13 +197,14 @@ public:
         // Check connection
         uint8_t whoAmI = readRegister(0x75);  // WHO_AM_I register
         if (whoAmI != 0x68 && whoAmI != 0x98) {
-            Serial.println("IMU: MPU6050 not found!");
+            logger.println("IMU: MPU6050 not found!");
             return false;
         }
 
-        // Wake up MPU6050
+        // Wake up MPU6050; update() starts once the gyro has settled
         writeRegister(MPU6050_PWR_MGMT_1, 0x00);
-        delay(100);
+        wakeUs = micros();
+        settled = false;
 
         // Sample rate = 1kHz / (1 + SMPLRT_DIV)
         writeRegister(MPU6050_SMPLRT_DIV, 9);  // 100Hz
@@ -189,14 +221,17 @@ public:
         initialized = true;
         lastUpdate = micros();
 
-        Serial.println("IMU: MPU6050 initialized");
+        logger.println("IMU: MPU6050 initialized");
         return true;
     }
 
     void calibrate(int samples = 500) {
         if (!initialized) return;
 
-        Serial.println("IMU: Calibrating... Keep device still!");
+        logger.println("IMU: Calibrating... Keep device still!");
+        while (!isReady()) {
+            delay(1);
+        }
 
         int32_t gyroSum[3] = {0, 0, 0};
         int32_t accelSum[3] = {0, 0, 0};
@@ -216,10 +251,51 @@ public:
         }
         // Z accel should be ~16384 (1g) when flat
         accelOffset[2] -= 16384;
+        for (int j = 0; j < 3; j++) {
+            gyroBias[j] = gyroOffset[j];
+        }
+        saveOffsets();
 
-        Serial.println("IMU: Calibration complete");
-        Serial.printf("  Gyro offset: %d, %d, %d\n", gyroOffset[0], gyroOffset[1], gyroOffset[2]);
-        Serial.printf("  Accel offset: %d, %d, %d\n", accelOffset[0], accelOffset[1], accelOffset[2]);
+        logger.println("IMU: Calibration complete");
+        logger.printf("  Gyro offset: %d, %d, %d\n", gyroOffset[0], gyroOffset[1], gyroOffset[2]);
+        logger.printf("  Accel offset: %d, %d, %d\n", accelOffset[0], accelOffset[1], accelOffset[2]);
+    }
+
+    // Offsets from the last calibrate(), kept in NVS so a restart can skip it
+    bool loadOffsets() {
+#ifdef ESP32
+        Preferences prefs;
+        if (!prefs.begin(IMU_NVS_NAMESPACE, true)) return false;
+        bool ok = prefs.getBytes("gyro", gyroOffset, sizeof(gyroOffset)) == sizeof(gyroOffset) &&
+                  prefs.getBytes("accel", accelOffset, sizeof(accelOffset)) == sizeof(accelOffset);
+        prefs.end();
+        for (int j = 0; j < 3; j++) {
+            gyroBias[j] = gyroOffset[j];
+        }
+        return ok;
+#else
+        return false;
+#endif
+    }
+
+    void saveOffsets() {
+#ifdef ESP32
+        Preferences prefs;
+        if (!prefs.begin(IMU_NVS_NAMESPACE, false)) return;
+        prefs.putBytes("gyro", gyroOffset, sizeof(gyroOffset));
+        prefs.putBytes("accel", accelOffset, sizeof(accelOffset));
+        prefs.end();
+#endif
+    }
+
+    // Follow gyro drift (temperature) while still; not written back to NVS
+    void setBiasTracking(bool enabled) { trackBias = enabled; }
+
+    // Latched: the elapsed time wraps with micros() (~71 min), readiness doesn't
+    bool isReady() const {
+        if (!initialized) return false;
+        if (!settled && micros() - wakeUs >= IMU_STARTUP_MS * 1000UL) settled = true;
+        return settled;
     }
 
     void readRawData() {
@@ -236,7 +312,7 @@ public:
     }
 
     void update() {
-        if (!initialized) return;
+        if (!isReady()) return;
 
         // Calculate dt
         unsigned long now = micros();
@@ -257,6 +333,10 @@ public:
         gyro[1] = (gyroRaw[1] - gyroOffset[1]) / 131.0f;
         gyro[2] = (gyroRaw[2] - gyroOffset[2]) / 131.0f;
 
+        if (trackBias) {
+            updateBias();
+        }
+
         // Update orientation using Madgwick filter
         madgwickUpdate(gyro[0], gyro[1], gyro[2], accel[0], accel[1], accel[2]);
 
@@ -277,7 +357,7 @@ public:
 
     // For debugging
     void printData() {
-        Serial.printf("IMU: Y=%.1f P=%.1f R=%.1f | Q=(%.3f,%.3f,%.3f,%.3f)\n",
+        logger.printf("IMU: Y=%.1f P=%.1f R=%.1f | Q=(%.3f,%.3f,%.3f,%.3f)\n",
             yaw, pitch, roll, quat.w, quat.x, quat.y, quat.z);
     }
 };
@@ -0,0 +1,257 @@
+#pragma once
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include "SpscRing.h"
+
+// Asynchronous log for all human-readable output
+//
+// print()/println()/printf() don't touch Serial. They store a compact
+// binary record - the format string pointer (its id) plus up to
+// LOG_MAX_ARGS raw arguments - in a lock-free ring and return. Formatting
+// and the blocking UART write happen later, in a low-priority task on the
+// other core (ESP32) or in service() when loop() is idle (other boards).
+// A full ring drops the record and counts it instead of waiting, so debug
+// verbosity never changes sampling or loop timing.
+//
+// Rules:
+//   - Log from loop()'s task only (setup() counts); the ring has one producer
+//   - Format strings and %s arguments must be static (literals, name tables);
+//     use copyln() for text that lives on the stack
+//   - printf-style conversions; the argument's own type picks d/u/f/s/c, so
+//     "%d" with a float still prints the float
+
+// ============ CONFIG ============
+#define LOG_RING_SIZE       128    // Records (power of two); setup() + help is ~50
+#define LOG_MAX_ARGS        8
+#define LOG_LINE_MAX        160    // Longest formatted record
+#define LOG_TASK_CORE       0      // Away from loop(); below the acquisition task
+#define LOG_TASK_PRIORITY   1
+#define LOG_TASK_STACK      3072
+#define LOG_POLL_MS         5      // Drain interval
+
+#ifdef ESP32
+#define LOG_TASK                   // Drain in a FreeRTOS task
+#endif
+
+enum LogArgType : uint8_t {
+  LOG_ARG_INT,
+  LOG_ARG_UINT,
+  LOG_ARG_FLOAT,
+  LOG_ARG_STR,
+  LOG_ARG_CHAR
+};
+
+union LogValue {
+  long i;
+  unsigned long u;
+  float f;
+  const char* s;
+};
+
+struct LogRecord {
+  const char* format;              // nullptr = inline text in value[]
+  uint8_t newline;
+  uint8_t count;
+  uint8_t type[LOG_MAX_ARGS];
+  LogValue value[LOG_MAX_ARGS];
+};
+
+class Logger {
+private:
+  SpscRing<LogRecord, LOG_RING_SIZE> ring;
+  uint32_t reportedDrops;          // Consumer side
+
+  // Argument capture; integer promotions pick the overload
+  static void set(LogRecord& r, int i, char c)           { r.type[i] = LOG_ARG_CHAR;  r.value[i].i = c; }
+  static void set(LogRecord& r, int i, int v)            { r.type[i] = LOG_ARG_INT;   r.value[i].i = v; }
+  static void set(LogRecord& r, int i, long v)           { r.type[i] = LOG_ARG_INT;   r.value[i].i = v; }
+  static void set(LogRecord& r, int i, unsigned int v)   { r.type[i] = LOG_ARG_UINT;  r.value[i].u = v; }
+  static void set(LogRecord& r, int i, unsigned long v)  { r.type[i] = LOG_ARG_UINT;  r.value[i].u = v; }
+  static void set(LogRecord& r, int i, double v)         { r.type[i] = LOG_ARG_FLOAT; r.value[i].f = (float)v; }
+  static void set(LogRecord& r, int i, const char* v)    { r.type[i] = LOG_ARG_STR;   r.value[i].s = v; }
+
+  static void capture(LogRecord&, int) {}
+
+  template <class T, class... Rest>
+  static void capture(LogRecord& r, int i, T first, Rest... rest) {
+    set(r, i, first);
+    capture(r, i + 1, rest...);
+  }
+
+  template <class... Args>
+  void push(const char* format, bool newline, Args... args) {
+    static_assert(sizeof...(Args) <= LOG_MAX_ARGS, "Too many log arguments");
+    LogRecord r;
+    r.format = format;
+    r.newline = newline;
+    r.count = sizeof...(Args);
+    capture(r, 0, args...);
+    ring.push(r);
+  }
+
+  // Format one conversion (spec is "%[flags][width][.prec]") by argument type
+  static int formatArg(char* out, size_t size, const char* spec, char conv,
+                       const LogRecord& r, int i) {
+    char fmt[16];
+    size_t n = strlen(spec);
+    if (n > sizeof(fmt) - 4) n = sizeof(fmt) - 4;
+    memcpy(fmt, spec, n);
+
+    bool hex = (conv == 'x' || conv == 'X');
+    switch (r.type[i]) {
+      case LOG_ARG_INT:
+        fmt[n++] = 'l';
+        fmt[n++] = hex ? conv : 'd';
+        fmt[n] = 0;
+        return snprintf(out, size, fmt, r.value[i].i);
+      case LOG_ARG_UINT:
+        fmt[n++] = 'l';
+        fmt[n++] = hex ? conv : 'u';
+        fmt[n] = 0;
+        return snprintf(out, size, fmt, r.value[i].u);
+      case LOG_ARG_FLOAT:
+        fmt[n++] = (conv == 'e' || conv == 'g') ? conv : 'f';
+        fmt[n] = 0;
+        return snprintf(out, size, fmt, (double)r.value[i].f);
+      case LOG_ARG_CHAR:
+        fmt[n++] = 'c';
+        fmt[n] = 0;
+        return snprintf(out, size, fmt, (int)r.value[i].i);
+      default:
+        fmt[n++] = 's';
+        fmt[n] = 0;
+        return snprintf(out, size, fmt, r.value[i].s ? r.value[i].s : "(null)");
+    }
+  }
+
+  // Expand a record into text; returns its length
+  static size_t format(const LogRecord& r, char* line, size_t size) {
+    size_t len = 0;
+    size_t room = size - 2;            // Keep space for "\r\n"
+
+    if (!r.format) {
+      const char* text = (const char*)r.value;
+      size_t n = strnlen(text, sizeof(r.value));
+      memcpy(line, text, n);
+      len = n;
+    } else {
+      int arg = 0;
+      for (const char* p = r.format; *p && len < room; p++) {
+        if (*p != '%') {
+          line[len++] = *p;
+          continue;
+        }
+        if (p[1] == '%') {
+          line[len++] = '%';
+          p++;
+          continue;
+        }
+
+        // Flags, width and precision; length modifiers are dropped
+        char spec[12];
+        size_t s = 0;
+        spec[s++] = '%';
+        const char* q = p + 1;
+        while (*q && strchr("-+ #0123456789.", *q)) {
+          if (s < sizeof(spec) - 1) spec[s++] = *q;
+          q++;
+        }
+        while (*q == 'l' || *q == 'h' || *q == 'z') q++;
+        spec[s] = 0;
+        if (!*q) break;
+
+        if (arg < r.count) {
+          int n = formatArg(line + len, room - len + 1, spec, *q, r, arg++);
+          if (n > 0) len += ((size_t)n < room - len) ? (size_t)n : room - len;
+        }
+        p = q;
+      }
+    }
+
+    if (r.newline) {
+      line[len++] = '\r';
+      line[len++] = '\n';
+    }
+    return len;
+  }
+
+  void write(const char* text, size_t len) {
+    Serial.write((const uint8_t*)text, len);
+  }
+
+#ifdef LOG_TASK
+  static void taskMain(void* arg) {
+    Logger* self = static_cast<Logger*>(arg);
+    for (;;) {
+      self->drain();
+      vTaskDelay(pdMS_TO_TICKS(LOG_POLL_MS));
+    }
+  }
+#endif
+
+public:
+  Logger() : reportedDrops(0) {}
+
+  // Call right after Serial.begin(); records made earlier wait in the ring
+  void begin() {
+#ifdef LOG_TASK
+    xTaskCreatePinnedToCore(&Logger::taskMain, "log", LOG_TASK_STACK,
+                            this, LOG_TASK_PRIORITY, nullptr, LOG_TASK_CORE);
+#endif
+  }
+
+  template <class... Args>
+  void print(const char* format, Args... args) { push(format, false, args...); }
+
+  template <class... Args>
+  void println(const char* format, Args... args) { push(format, true, args...); }
+
+  void println() { push("", true); }
+
+  template <class... Args>
+  void printf(const char* format, Args... args) { push(format, false, args...); }
+
+  // Text that won't outlive the call; copied into the record, truncated
+  // to sizeof(LogRecord::value) bytes
+  void copyln(const char* text) {
+    LogRecord r;
+    r.format = nullptr;
+    r.newline = true;
+    r.count = 0;
+    size_t n = strnlen(text, sizeof(r.value));
+    memset(r.value, 0, sizeof(r.value));
+    memcpy(r.value, text, n);
+    ring.push(r);
+  }
+
+  // Consumer side: format and write everything queued
+  void drain() {
+    char line[LOG_LINE_MAX];
+    LogRecord r;
+    while (ring.pop(r)) {
+      write(line, format(r, line, sizeof(line)));
+    }
+
+    uint32_t dropped = ring.getDropped();
+    if (dropped != reportedDrops) {
+      int n = snprintf(line, sizeof(line), "[log] %lu records dropped\r\n",
+                       (unsigned long)(dropped - reportedDrops));
+      write(line, n);
+      reportedDrops = dropped;
+    }
+  }
+
+  // Call from loop() when idle; drains inline on boards without the log task
+  void service() {
+#ifndef LOG_TASK
+    drain();
+#endif
+  }
+
+  uint32_t getDropped() const { return ring.getDropped(); }
+  uint32_t pending() const { return ring.available(); }
+};
+
+extern Logger logger;
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stdint.h>
+#include "AdcEngine.h"
+#include "filter/Decimator.h"
+
+// Multi-rate sample streams
+//
+// The ADC engine captures every finger at ADC_FRAME_RATE_HZ. Each consumer
+// reads its own stream, decimated (CIC, see filter/Decimator.h) to the rate
+// it actually needs:
+//   STREAM_FULL     - every frame, for AirPiano note onsets
+//   STREAM_GESTURE  - GESTURE_RATE_HZ, for the static/dynamic matchers
+//   STREAM_HOST     - HOST_RATE_HZ, for OpenGloves / raw output to the PC
+// All streams are fed from the same frames, so switching consumers doesn't
+// restart a decimator. A stream's output is stamped with the time of the
+// last frame that went into it.
+
+// ============ CONFIG ============
+#define GESTURE_RATE_HZ   50     // Gesture matching (debounce counts are per output)
+#define HOST_RATE_HZ      100    // OpenGloves / raw stream to the host
+#define DECIMATOR_ORDER   2
+
+enum SampleStream {
+  STREAM_FULL = 0,
+  STREAM_GESTURE,
+  STREAM_HOST,
+  STREAM_COUNT
+};
+
+class MultiRateSampler {
+private:
+  CicDecimator<ADC_ENGINE_CHANNELS, DECIMATOR_ORDER> decimator[STREAM_COUNT];
+  AdcFrame latest[STREAM_COUNT];
+  bool fresh[STREAM_COUNT];
+
+public:
+  MultiRateSampler() {
+    for (int s = 0; s < STREAM_COUNT; s++) {
+      fresh[s] = false;
+    }
+    setRate(STREAM_FULL, ADC_FRAME_RATE_HZ);
+    setRate(STREAM_GESTURE, GESTURE_RATE_HZ);
+    setRate(STREAM_HOST, HOST_RATE_HZ);
+  }
+
+  // Output rate is ADC_FRAME_RATE_HZ divided by a whole number, so the
+  // actual rate may be a little above the request. Same ratio = no restart.
+  void setRate(SampleStream stream, uint16_t hz) {
+    uint16_t ratio = (hz == 0 || hz >= ADC_FRAME_RATE_HZ) ? 1 : ADC_FRAME_RATE_HZ / hz;
+    if (ratio == decimator[stream].getRatio()) return;
+    decimator[stream].setRatio(ratio);
+    fresh[stream] = false;
+  }
+
+  uint16_t getRate(SampleStream stream) const {
+    return ADC_FRAME_RATE_HZ / decimator[stream].getRatio();
+  }
+
+  uint16_t getPeriodMs(SampleStream stream) const {
+    return (uint16_t)(decimator[stream].getRatio() * 1000UL / ADC_FRAME_RATE_HZ);
+  }
+
+  void reset() {
+    for (int s = 0; s < STREAM_COUNT; s++) {
+      decimator[s].reset();
+      fresh[s] = false;
+    }
+  }
+
+  // Feed one full-rate frame to every stream
+  void push(const AdcFrame& frame) {
+    for (int s = 0; s < STREAM_COUNT; s++) {
+      int out[ADC_ENGINE_CHANNELS];
+      if (!decimator[s].push(frame.value, out)) continue;
+
+      latest[s].timestampUs = frame.timestampUs;
+      for (int ch = 0; ch < ADC_ENGINE_CHANNELS; ch++) {
+        latest[s].value[ch] = (uint16_t)out[ch];
+      }
+      fresh[s] = true;
+    }
+  }
+
+  // Newest output of a stream, once
+  bool read(SampleStream stream, AdcFrame& frame) {
+    if (!fresh[stream]) return false;
+    fresh[stream] = false;
+    frame = latest[stream];
+    return true;
+  }
+};
@@ -0,0 +1,193 @@
+#pragma once
+
+#include <Arduino.h>
+#include <string.h>
+#include "Config.h"
+#include "AnalogFilter.h"
+#ifdef ENABLE_PIANO
+#include "AirPiano.h"
+#endif
+#ifdef ENABLE_GESTURES
+#include "gesture/StaticMatcher.h"
+#endif
+
+#ifdef ESP32
+#include <Preferences.h>
+#endif
+
+// Runtime parameter registry
+//
+// Constants worth tuning on a glove in the field, by name:
+//   GET [name]          - one value, or all of them
+//   SET <name> <value>  - change it now (checked against its range)
+//   SAVE / DEFAULTS     - store all values in NVS / go back to the defaults
+// Values live in one fixed table; nothing is allocated. load() in setup()
+// restores what was saved. The sketch applies a value to its module (see
+// applyParams()), so a change takes effect on the next frame without a
+// restart. Names double as NVS keys, so they stay within 15 characters.
+// Gesture and piano entries exist only in builds with that feature.
+
+// ============ CONFIG ============
+#define PARAM_NVS_NAMESPACE  "vlove"
+
+enum ParamId : uint8_t {
+  PARAM_EURO_MIN_CUTOFF = 0,
+  PARAM_EURO_THUMB_CUTOFF,
+  PARAM_EURO_BETA,
+  PARAM_EURO_D_CUTOFF,
+  PARAM_KALMAN_Q,
+  PARAM_KALMAN_R,
+  PARAM_KALMAN_LEAD,
+  PARAM_RATE_GESTURE,
+  PARAM_RATE_HOST,
+#ifdef ENABLE_GESTURES
+  PARAM_GESTURE_DEBOUNCE,
+#endif
+#ifdef ENABLE_PIANO
+  PARAM_PIANO_ON,
+  PARAM_PIANO_OFF,
+  PARAM_PIANO_SPEED,
+  PARAM_PIANO_MIN_VELOCITY,
+#endif
+  PARAM_COUNT
+};
+
+struct ParamDef {
+  const char* name;
+  float minValue;
+  float maxValue;
+  float defaultValue;
+  bool integer;          // Rounded on SET, printed without decimals
+  const char* unit;
+};
+
+// Same order as ParamId
+const ParamDef PARAM_DEFS[PARAM_COUNT] = {
+  {"euro.mincut",   0.01f, 10.0f,    ONE_EURO_MIN_CUTOFF,        false, "Hz"},
+  {"euro.thumb",    0.01f, 10.0f,    ONE_EURO_THUMB_MIN_CUTOFF,  false, "Hz"},
+  {"euro.beta",     0.0f,  0.1f,     ONE_EURO_BETA,              false, "Hz per count/s"},
+  {"euro.dcut",     0.1f,  10.0f,    ONE_EURO_D_CUTOFF,          false, "Hz"},
+  {"kalman.q",      100.0f, 1000000.0f, KALMAN_PROCESS_NOISE,    false, "counts/s2"},
+  {"kalman.r",      0.1f,  500.0f,   KALMAN_MEASUREMENT_NOISE,   false, "counts"},
+  {"kalman.lead",   0.0f,  50.0f,    KALMAN_LEAD_MS,             false, "ms"},
+  {"rate.gesture",  5.0f,  ADC_FRAME_RATE_HZ, GESTURE_RATE_HZ,   true,  "Hz"},
+  {"rate.host",     5.0f,  ADC_FRAME_RATE_HZ, HOST_RATE_HZ,      true,  "Hz"},
+#ifdef ENABLE_GESTURES
+  {"gest.debounce", 1.0f,  20.0f,    STATIC_DEBOUNCE_FRAMES,     true,  "frames"},
+#endif
+#ifdef ENABLE_PIANO
+  {"piano.on",      0.0f,  ANALOG_MAX, PIANO_ON_THRESHOLD,       true,  "counts"},
+  {"piano.off",     0.0f,  ANALOG_MAX, PIANO_OFF_THRESHOLD,      true,  "counts"},
+  {"piano.speed",   1000.0f, 200000.0f, PIANO_FULL_SPEED,        false, "counts/s"},
+  {"piano.minvel",  1.0f,  127.0f,   PIANO_MIN_VELOCITY,         true,  "velocity"},
+#endif
+};
+
+class ParamRegistry {
+private:
+  float values[PARAM_COUNT];
+  bool dirty;            // Changed since the last load() / save()
+
+public:
+  ParamRegistry() : dirty(false) {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      values[i] = PARAM_DEFS[i].defaultValue;
+    }
+  }
+
+  // Id of a parameter name (case-insensitive), -1 if unknown
+  static int find(const char* name) {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      if (strcasecmp(name, PARAM_DEFS[i].name) == 0) return i;
+    }
+    return -1;
+  }
+
+  static const ParamDef& def(ParamId id) { return PARAM_DEFS[id]; }
+
+  float get(ParamId id) const { return values[id]; }
+  int getInt(ParamId id) const { return (int)values[id]; }
+
+  // False (value unchanged) if out of range
+  bool set(ParamId id, float value) {
+    const ParamDef& d = PARAM_DEFS[id];
+    if (!(value >= d.minValue && value <= d.maxValue)) return false;   // Also rejects NaN
+    if (d.integer) value = (float)(long)(value + 0.5f);
+    if (value != values[id]) {
+      values[id] = value;
+      dirty = true;
+    }
+    return true;
+  }
+
+  bool isDirty() const { return dirty; }
+
+  void resetDefaults() {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      set((ParamId)i, PARAM_DEFS[i].defaultValue);
+    }
+  }
+
+  // Saved values; missing or out-of-range ones keep their default
+  // Returns how many were restored
+  int load() {
+    int restored = 0;
+#ifdef ESP32
+    Preferences prefs;
+    if (!prefs.begin(PARAM_NVS_NAMESPACE, true)) return 0;
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      if (!prefs.isKey(PARAM_DEFS[i].name)) continue;
+      if (set((ParamId)i, prefs.getFloat(PARAM_DEFS[i].name, values[i]))) restored++;
+    }
+    prefs.end();
+#endif
+    dirty = false;
+    return restored;
+  }
+
+  // Store every value (NVS skips the flash write for unchanged ones)
+  bool save() {
+#ifdef ESP32
+    Preferences prefs;
+    if (!prefs.begin(PARAM_NVS_NAMESPACE, false)) return false;
+    bool ok = true;
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      ok &= prefs.putFloat(PARAM_DEFS[i].name, values[i]) == sizeof(float);
+    }
+    prefs.end();
+    if (ok) dirty = false;
+    return ok;
+#else
+    return false;
+#endif
+  }
+
+  // Forget the saved values (defaults from the next boot)
+  bool clearSaved() {
+#ifdef ESP32
+    Preferences prefs;
+    if (!prefs.begin(PARAM_NVS_NAMESPACE, false)) return false;
+    bool ok = prefs.clear();
+    prefs.end();
+    if (ok) dirty = false;    // Saved state is the defaults again
+    return ok;
+#else
+    return false;
+#endif
+  }
+
+  // Filter constants in AnalogFilter form
+  FilterTuning filterTuning() const {
+    FilterTuning t;
+    t.oneEuroMinCutoff = values[PARAM_EURO_MIN_CUTOFF];
+    t.oneEuroThumbMinCutoff = values[PARAM_EURO_THUMB_CUTOFF];
+    t.oneEuroBeta = values[PARAM_EURO_BETA];
+    t.oneEuroDCutoff = values[PARAM_EURO_D_CUTOFF];
+    t.kalmanProcessNoise = values[PARAM_KALMAN_Q];
+    t.kalmanMeasurementNoise = values[PARAM_KALMAN_R];
+    t.kalmanLeadMs = values[PARAM_KALMAN_LEAD];
+    t.gestureRateHz = (uint16_t)values[PARAM_RATE_GESTURE];
+    t.hostRateHz = (uint16_t)values[PARAM_RATE_HOST];
+    return t;
+  }
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdint.h>
+#include "Config.h"
+
+// Per-channel mapping: filtered value -> calibrated position
+//
+// Everything between the filters and the consumers reduces to a Q16 scale
+// factor per channel, recomputed only when the calibration changes:
+//   - calibrated range (min/max -> 0-ANALOG_MAX, clamped)
+//   - optional ADC linearization (CAL_ADC_LINEARIZE)
+//   - 0-255 normalization used by the gesture matchers
+// A frame then costs a subtract, a multiply and a shift per channel, with
+// no divide and no tables (the 0-255 scale is one more multiply).
+//
+// Inversion and the thumb offset stay in front of the filters: velocity
+// sign, noise bands and the stored calibration are all defined on the
+// inverted, offset value. The mapping uses them only to recover the true
+// ADC code for linearization.
+
+// ============ CONFIG ============
+// #define CAL_ADC_LINEARIZE     // Correct the ADC transfer curve with ADC_LINEAR_TABLE
+
+// p * 255 / ANALOG_MAX as a Q16 multiply; rounded up, it is exact for 12 bits
+#define CAL_NORM_Q16   ((255UL * 65536 + ANALOG_MAX - 1) / ANALOG_MAX)
+
+#ifdef CAL_ADC_LINEARIZE
+// Linear code for ADC codes 0, 256, ... 4096 (17 knots). Identity as
+// shipped; measure per board, e.g. analogReadMilliVolts() against a known
+// divider, and scale millivolts to 0-4095.
+static const uint16_t ADC_LINEAR_TABLE[17] = {
+  0, 256, 512, 768, 1024, 1280, 1536, 1792, 2048,
+  2304, 2560, 2816, 3072, 3328, 3584, 3840, 4096
+};
+#endif
+
+class PositionMap {
+private:
+  struct Channel {
+    int lo;            // Linearized calibration minimum
+    int span;          // Linearized max - min
+    uint32_t scale;    // ANALOG_MAX / span, Q16
+    bool inverted;
+    int offset;
+  };
+
+  Channel channels[SENSOR_COUNT];
+
+  // Filtered value -> same scale with the ADC curve corrected
+  int linearize(int finger, int v) const {
+#ifdef CAL_ADC_LINEARIZE
+    const Channel& c = channels[finger];
+    int code = c.inverted ? ANALOG_MAX - (v + c.offset) : v + c.offset;
+    if (code < 0) code = 0;
+    if (code > ANALOG_MAX) code = ANALOG_MAX;
+
+    int knot = code >> 8;
+    int step = ADC_LINEAR_TABLE[knot + 1] - ADC_LINEAR_TABLE[knot];
+    int lin = ADC_LINEAR_TABLE[knot] + ((step * (code & 255) + 128) >> 8);
+
+    return c.inverted ? ANALOG_MAX - lin - c.offset : lin - c.offset;
+#else
+    (void)finger;
+    return v;
+#endif
+  }
+
+public:
+  PositionMap() {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      channels[i].inverted = false;
+      channels[i].offset = 0;
+      build(i, 0, ANALOG_MAX);
+    }
+  }
+
+  // How the filtered value was derived from the ADC code (for linearization)
+  void setInput(int finger, bool invert, int inputOffset) {
+    channels[finger].inverted = invert;
+    channels[finger].offset = inputOffset;
+  }
+
+  // Compute one finger's scale; an empty range passes values through
+  void build(int finger, int minVal, int maxVal) {
+    Channel& c = channels[finger];
+    int lo = linearize(finger, minVal);
+    int hi = linearize(finger, maxVal);
+    if (hi <= lo) {
+      lo = 0;
+      hi = ANALOG_MAX;
+    }
+    c.lo = lo;
+    c.span = hi - lo;
+    c.scale = (((uint32_t)ANALOG_MAX << 16) + c.span / 2) / c.span;
+  }
+
+  // Filtered value (0-ANALOG_MAX) -> calibrated position (0-ANALOG_MAX)
+  int map(int finger, int value) const {
+    const Channel& c = channels[finger];
+    int d = linearize(finger, value) - c.lo;
+    if (d <= 0) return 0;
+    if (d >= c.span) return ANALOG_MAX;
+    // d < span keeps the product below ANALOG_MAX << 16
+    return (int)(((uint32_t)d * c.scale + 0x8000) >> 16);
+  }
+
+  // Filtered value (0-ANALOG_MAX) -> calibrated position (0-255)
+  uint8_t normalize(int finger, int value) const {
+    return toByte(map(finger, value));
+  }
+
+  // Both scales for every channel of a frame
+  void mapFrame(const int* value, int16_t* pos, uint8_t* norm) const {
+    for (int ch = 0; ch < SENSOR_COUNT; ch++) {
+      int p = map(ch, value[ch]);
+      pos[ch] = (int16_t)p;
+      norm[ch] = toByte(p);
+    }
+  }
+
+private:
+  static uint8_t toByte(int position) {
+    return (uint8_t)(((uint32_t)position * CAL_NORM_Q16) >> 16);
+  }
+};
@@ -0,0 +1,182 @@
+#pragma once
+
+#include <Arduino.h>
+#include "Config.h"
+#include "AcquisitionTask.h"
+
+#ifdef ESP32
+#include <esp_sleep.h>
+#include <driver/uart.h>
+#endif
+
+// Mode-aware duty cycling
+//
+// Each mode sets a policy: CPU clock while active, and when it may idle.
+//   ACTIVE - sampling and filtering at full rate, CPU at the policy clock
+//   IDLE   - sampling paused, CPU at POWER_LOW_MHZ; loop() probes the
+//            fingers with analogRead() at POWER_IDLE_RATE_HZ and sleeps in
+//            between (light sleep when Bluetooth is off, delay otherwise)
+// A probe that sees any finger move more than POWER_WAKE_DELTA from where
+// it went idle restarts sampling at once, so the first full-rate frame is
+// one ADC period after the probe. Changing mode also wakes it.
+//
+// Light sleep stops both cores, and the UART drops the character that
+// wakes it. So HOME (the menu, where commands are expected) never light-
+// sleeps, and the other modes only after POWER_SLEEP_QUIET_MS without
+// serial input; until then idle waits with delay() at POWER_LOW_MHZ.
+
+// ============ CONFIG ============
+#define POWER_ACTIVE_MHZ      240
+#define POWER_LOW_MHZ         80     // Lowest clock Bluetooth / APB run at
+#define POWER_IDLE_RATE_HZ    10     // Motion probes per second while idle
+#define POWER_IDLE_AFTER_MS   10000  // Hand still this long before idling
+#define POWER_WAKE_DELTA      120    // Raw counts a finger must move to wake
+#define POWER_SLEEP_QUIET_MS  30000  // No serial input this long before light sleep
+
+enum PowerIdle : uint8_t {
+  POWER_IDLE_NEVER,        // Host links that expect a steady stream
+  POWER_IDLE_WHEN_STILL,   // After POWER_IDLE_AFTER_MS without motion
+  POWER_IDLE_ALWAYS        // Nothing consumes frames (HOME)
+};
+
+class PowerScheduler {
+private:
+  AcquisitionTask& acquisition;
+  AnalogFilter& filter;
+
+  uint16_t activeMhz;
+  PowerIdle idlePolicy;
+  bool idle;
+  bool lightSleep;
+  uint32_t lastMotionMs;
+  uint32_t lastInputMs;
+  int reference[SENSOR_COUNT];  // Raw positions when idling started
+  bool hasReference;
+  uint32_t idleSinceMs;
+  uint32_t idleTotalMs;
+  uint16_t wakeCount;
+
+  void setCpu(uint16_t mhz) {
+#ifdef ESP32
+    if (getCpuFrequencyMhz() != mhz) setCpuFrequencyMhz(mhz);
+#else
+    (void)mhz;
+#endif
+  }
+
+  void probe(int values[SENSOR_COUNT]) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      values[i] = filter.readRawOversampled(filter.getPin(i), filter.isInverted(i));
+    }
+  }
+
+  void enterIdle(uint32_t nowMs) {
+    idle = true;
+    idleSinceMs = nowMs;
+    hasReference = false;        // First probe, once the task has let go of the ADC
+    acquisition.setPaused(true);
+    setCpu(POWER_LOW_MHZ);
+  }
+
+  void wake(uint32_t nowMs) {
+    idle = false;
+    idleTotalMs += nowMs - idleSinceMs;
+    wakeCount++;
+    lastMotionMs = nowMs;
+    setCpu(activeMhz);
+    acquisition.setPaused(false);
+  }
+
+public:
+  PowerScheduler(AcquisitionTask& task, AnalogFilter& analogFilter)
+    : acquisition(task), filter(analogFilter), activeMhz(POWER_ACTIVE_MHZ),
+      idlePolicy(POWER_IDLE_NEVER), idle(false), lightSleep(false), lastMotionMs(0), lastInputMs(0), hasReference(false),
+      idleSinceMs(0), idleTotalMs(0), wakeCount(0) {
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      reference[i] = 0;
+    }
+  }
+
+  // Policy of the current mode; a change wakes the glove
+  void setPolicy(uint16_t cpuMhz, PowerIdle policy) {
+    if (cpuMhz == activeMhz && policy == idlePolicy) return;
+    activeMhz = cpuMhz;
+    idlePolicy = policy;
+    uint32_t now = millis();
+    if (idle) {
+      wake(now);
+    } else {
+      lastMotionMs = now;
+      setCpu(activeMhz);
+    }
+  }
+
+  // Light sleep between probes (not with Bluetooth on: it drops the link)
+  void setLightSleep(bool allowed) { lightSleep = allowed; }
+
+  // Serial input arrived: keep the UART awake for POWER_SLEEP_QUIET_MS
+  void noteInput(uint32_t nowMs) { lastInputMs = nowMs; }
+
+  // Call every loop() while active; `still` = no finger moving
+  void update(uint32_t nowMs, bool still) {
+    if (idle) return;
+    if (!still) {
+      lastMotionMs = nowMs;
+    }
+    if (idlePolicy == POWER_IDLE_ALWAYS ||
+        (idlePolicy == POWER_IDLE_WHEN_STILL && nowMs - lastMotionMs >= POWER_IDLE_AFTER_MS)) {
+      enterIdle(nowMs);
+    }
+  }
+
+  // Idle: sleep one probe period, then check for motion
+  void sleep() {
+    const uint32_t periodUs = 1000000UL / POWER_IDLE_RATE_HZ;
+#ifdef ESP32
+    if (lightSleep && idlePolicy != POWER_IDLE_ALWAYS && millis() - lastInputMs >= POWER_SLEEP_QUIET_MS) {
+      Serial.flush();
+      esp_sleep_enable_timer_wakeup(periodUs);
+      uart_set_wakeup_threshold(UART_NUM_0, 3);
+      esp_sleep_enable_uart_wakeup(UART_NUM_0);
+      esp_light_sleep_start();
+    } else {
+      delay(periodUs / 1000);
+    }
+#else
+    delay(periodUs / 1000);
+#endif
+
+    if (idlePolicy == POWER_IDLE_ALWAYS || !acquisition.isPaused()) return;
+
+    int values[SENSOR_COUNT];
+    probe(values);
+    if (!hasReference) {
+      memcpy(reference, values, sizeof(reference));
+      hasReference = true;
+      return;
+    }
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      if (abs(values[i] - reference[i]) > POWER_WAKE_DELTA) {
+        wake(millis());
+        return;
+      }
+    }
+  }
+
+  bool isIdle() const { return idle; }
+
+  uint16_t getCpuMhz() const {
+#ifdef ESP32
+    return getCpuFrequencyMhz();
+#else
+    return idle ? POWER_LOW_MHZ : activeMhz;
+#endif
+  }
+  uint16_t getActiveMhz() const { return activeMhz; }
+  uint16_t getWakeCount() const { return wakeCount; }
+
+  // Time spent idle, including the current idle period
+  uint32_t getIdleMs(uint32_t nowMs) const {
+    return idleTotalMs + (idle ? nowMs - idleSinceMs : 0);
+  }
+};
@@ -0,0 +1,201 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include "Config.h"
+
+// Per-stage cost of a frame (ENABLE_PROFILER)
+//
+// PROFILE_SCOPE(stage) at the top of a block times the block in CPU cycles
+// (microseconds on boards without a cycle counter) and adds it to that
+// stage's min / avg / max and a log-linear histogram for the p99. STATS
+// prints the table, STATS RESET starts over. Without ENABLE_PROFILER the
+// macro is empty and none of this is compiled.
+//
+// Each stage is recorded from one thread: FILTER and PUBLISH in the
+// acquisition task (core 0 with ENABLE_DUAL_CORE), the rest in loop().
+// STATS reads while frames keep coming, so a line may mix two frames; a
+// reset is only a request that the recording side carries out. Scopes nest:
+// GESTURE and PIANO include the events they publish, LOOP includes every
+// stage run by loop() for the frame.
+
+enum ProfileStage : uint8_t {
+  PROF_FILTER = 0,   // ADC frame -> filtered values and onsets
+  PROF_PUBLISH,      // Decimate and publish to the streams
+  PROF_FRAME,        // Calibrate into a FingerFrame (nextFrame)
+  PROF_FEATURES,     // Motion features
+  PROF_GESTURE,      // Static + dynamic recognition
+  PROF_PIANO,        // Note detection
+  PROF_COMM,         // One protocol line out
+  PROF_LOOP,         // All of loop()'s work for a frame
+  PROF_STAGE_COUNT
+};
+
+#ifdef ENABLE_PROFILER
+
+// ============ CONFIG ============
+#define PROFILE_SUB_BITS  3    // Histogram buckets per power of two: 2^3 (p99 within 12.5%)
+
+#define PROFILE_SUB       (1 << PROFILE_SUB_BITS)
+#define PROFILE_BUCKETS   ((33 - PROFILE_SUB_BITS) * PROFILE_SUB)
+
+#ifdef ESP32
+#define PROFILE_UNIT      "cycles"
+inline uint32_t profileClock() { return ESP.getCycleCount(); }
+#else
+#define PROFILE_UNIT      "us"
+inline uint32_t profileClock() { return micros(); }
+#endif
+
+class Profiler {
+public:
+  struct Summary {
+    uint32_t count;
+    uint32_t min;
+    uint32_t avg;
+    uint32_t max;
+    uint32_t p99;
+  };
+
+private:
+  struct Stage {
+    uint32_t count;
+    uint64_t total;
+    uint32_t min;
+    uint32_t max;
+    uint16_t buckets[PROFILE_BUCKETS];   // Halved together when one fills
+    std::atomic<bool> resetRequested;
+  };
+
+  Stage stages[PROF_STAGE_COUNT];
+
+  static void clear(Stage& s) {
+    s.count = 0;
+    s.total = 0;
+    s.min = UINT32_MAX;
+    s.max = 0;
+    memset(s.buckets, 0, sizeof(s.buckets));
+  }
+
+  // Exact below 2 * PROFILE_SUB, then PROFILE_SUB buckets per power of two
+  static int bucketOf(uint32_t v) {
+    if (v < 2 * PROFILE_SUB) return (int)v;
+    int msb = 31 - __builtin_clz(v);
+    return (msb - PROFILE_SUB_BITS + 1) * PROFILE_SUB +
+           (int)((v >> (msb - PROFILE_SUB_BITS)) & (PROFILE_SUB - 1));
+  }
+
+  // Largest value that falls in bucket b
+  static uint32_t bucketTop(int b) {
+    if (b < 2 * PROFILE_SUB) return (uint32_t)b;
+    int shift = b / PROFILE_SUB - 1;
+    uint64_t base = (uint64_t)(PROFILE_SUB + b % PROFILE_SUB) << shift;
+    uint64_t top = base + ((uint64_t)1 << shift) - 1;
+    return top > UINT32_MAX ? UINT32_MAX : (uint32_t)top;
+  }
+
+public:
+  Profiler() {
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+      clear(stages[i]);
+      stages[i].resetRequested = false;
+    }
+  }
+
+  void record(ProfileStage stage, uint32_t ticks) {
+    Stage& s = stages[stage];
+    if (s.resetRequested.load(std::memory_order_relaxed)) {
+      clear(s);
+      s.resetRequested.store(false, std::memory_order_relaxed);
+    }
+    s.count++;
+    s.total += ticks;
+    if (ticks < s.min) s.min = ticks;
+    if (ticks > s.max) s.max = ticks;
+
+    uint16_t& bucket = s.buckets[bucketOf(ticks)];
+    if (bucket == UINT16_MAX) {
+      for (int b = 0; b < PROFILE_BUCKETS; b++) {
+        s.buckets[b] >>= 1;
+      }
+    }
+    bucket++;
+  }
+
+  // Start over (carried out at each stage's next record)
+  void reset() {
+    for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+      stages[i].resetRequested.store(true, std::memory_order_relaxed);
+    }
+  }
+
+  // False if the stage has no samples yet
+  bool summarize(ProfileStage stage, Summary& out) const {
+    const Stage& s = stages[stage];
+    if (s.count == 0 || s.resetRequested.load(std::memory_order_relaxed)) return false;
+    out.count = s.count;
+    out.min = s.min;
+    out.max = s.max;
+    out.avg = (uint32_t)(s.total / s.count);
+
+    uint32_t inHistogram = 0;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+      inHistogram += s.buckets[b];
+    }
+    uint32_t target = inHistogram - inHistogram / 100;   // 99% at or below
+    uint32_t seen = 0;
+    out.p99 = s.max;
+    for (int b = 0; b < PROFILE_BUCKETS; b++) {
+      seen += s.buckets[b];
+      if (seen >= target && seen > 0) {
+        uint32_t top = bucketTop(b);
+        out.p99 = top < s.max ? top : s.max;
+        break;
+      }
+    }
+    return true;
+  }
+
+  static const char* stageName(ProfileStage stage) {
+    switch (stage) {
+      case PROF_FILTER:   return "filter";
+      case PROF_PUBLISH:  return "publish";
+      case PROF_FRAME:    return "frame";
+      case PROF_FEATURES: return "features";
+      case PROF_GESTURE:  return "gesture";
+      case PROF_PIANO:    return "piano";
+      case PROF_COMM:     return "comm";
+      case PROF_LOOP:     return "loop";
+      default:            return "?";
+    }
+  }
+};
+
+extern Profiler profiler;
+
+// Times the rest of the enclosing block
+// (PROFILE_START / PROFILE_STOP for spans that are only sometimes recorded)
+class ProfileScope {
+private:
+  ProfileStage stage;
+  uint32_t start;
+
+public:
+  explicit ProfileScope(ProfileStage s) : stage(s), start(profileClock()) {}
+  ~ProfileScope() { profiler.record(stage, profileClock() - start); }
+};
+
+#define PROFILE_CONCAT_(a, b)  a##b
+#define PROFILE_CONCAT(a, b)   PROFILE_CONCAT_(a, b)
+#define PROFILE_SCOPE(stage)   ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(stage)
+#define PROFILE_START(t)       uint32_t t = profileClock()
+#define PROFILE_STOP(t, stage) profiler.record(stage, profileClock() - (t))
+
+#else
+
+#define PROFILE_SCOPE(stage)   ((void)0)
+#define PROFILE_START(t)       ((void)0)
+#define PROFILE_STOP(t, stage) ((void)0)
+
+#endif
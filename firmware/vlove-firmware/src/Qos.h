@@ -0,0 +1,146 @@
+#pragma once
+
+#include <stdint.h>
+
+// Frame budget tracking and graceful degradation
+//
+// loop() reports how long each frame's work took. Work longer than
+// QOS_BUDGET_PERCENT of the frame period is an overrun. Every QOS_WINDOW_MS
+// the governor looks back over the window:
+//   - overruns above QOS_SHED_PERCENT of frames -> shed one more level
+//   - QOS_RECOVER_WINDOWS clean windows in a row, with the loop busy less
+//     than QOS_RECOVER_PERCENT of the time -> restore one level
+// Levels shed optional work in a fixed order, each keeping the ones before:
+//   QOS_NO_DEBUG       per-frame human-readable reports (gesture, piano)
+//   QOS_NO_CONFIDENCE  static matcher skips confidence scoring
+//   QOS_NO_DYNAMIC     dynamic gesture tracking paused
+//   QOS_REDUCED_RATE   host output (OpenGloves / raw) at 1/QOS_RATE_DIVIDER
+// Note triggers and protocol messages are never shed.
+
+// ============ CONFIG ============
+#define QOS_BUDGET_PERCENT    80    // Work allowed per frame, % of its period
+#define QOS_WINDOW_MS         250
+#define QOS_SHED_PERCENT      5     // Overrun frames in a window that shed a level
+#define QOS_RECOVER_PERCENT   50    // Loop busy below this counts as headroom
+#define QOS_RECOVER_WINDOWS   8     // Clean windows before restoring a level (2 s)
+#define QOS_RATE_DIVIDER      2
+
+enum QosLevel : uint8_t {
+  QOS_FULL = 0,
+  QOS_NO_DEBUG,
+  QOS_NO_CONFIDENCE,
+  QOS_NO_DYNAMIC,
+  QOS_REDUCED_RATE,
+  QOS_LEVEL_COUNT
+};
+
+class QosGovernor {
+private:
+  QosLevel level;
+  uint32_t budgetUs;
+
+  // Current window
+  uint32_t windowStartMs;
+  uint32_t frames;
+  uint32_t overruns;
+  uint32_t busyUs;
+
+  // Last completed window
+  uint8_t lastLoad;               // % of the window spent working
+  uint8_t cleanWindows;
+
+  // Lifetime
+  uint32_t totalFrames;
+  uint32_t totalOverruns;
+  uint32_t worstUs;
+  uint16_t levelChanges;
+
+  void startWindow(uint32_t nowMs) {
+    windowStartMs = nowMs;
+    frames = 0;
+    overruns = 0;
+    busyUs = 0;
+  }
+
+public:
+  QosGovernor() : level(QOS_FULL), budgetUs(10000), lastLoad(0), cleanWindows(0) {
+    resetStats();
+    startWindow(0);
+  }
+
+  // Frame period of the fastest consumer; budget follows from it
+  void setFramePeriodUs(uint32_t periodUs) {
+    budgetUs = periodUs * QOS_BUDGET_PERCENT / 100;
+  }
+
+  // Work done for one frame
+  void record(uint32_t workUs) {
+    frames++;
+    totalFrames++;
+    busyUs += workUs;
+    if (workUs > worstUs) worstUs = workUs;
+    if (workUs > budgetUs) {
+      overruns++;
+      totalOverruns++;
+    }
+  }
+
+  // Call every loop(); true when the level changed
+  bool update(uint32_t nowMs) {
+    uint32_t elapsed = nowMs - windowStartMs;
+    if (elapsed < QOS_WINDOW_MS) return false;
+
+    uint32_t load = busyUs / (elapsed * 10);   // busy us / elapsed ms -> %
+    lastLoad = load > 100 ? 100 : (uint8_t)load;
+    bool overloaded = overruns > 0 && overruns * 100 >= frames * QOS_SHED_PERCENT;
+    bool headroom = overruns == 0 && lastLoad < QOS_RECOVER_PERCENT;
+    startWindow(nowMs);
+
+    if (overloaded) {
+      cleanWindows = 0;
+      if (level + 1 < QOS_LEVEL_COUNT) {
+        level = (QosLevel)(level + 1);
+        levelChanges++;
+        return true;
+      }
+    } else if (headroom) {
+      if (++cleanWindows >= QOS_RECOVER_WINDOWS && level > QOS_FULL) {
+        cleanWindows = 0;
+        level = (QosLevel)(level - 1);
+        levelChanges++;
+        return true;
+      }
+    } else {
+      cleanWindows = 0;
+    }
+    return false;
+  }
+
+  // True if optional work at this level is currently shed
+  bool sheds(QosLevel l) const { return level >= l; }
+
+  QosLevel getLevel() const { return level; }
+  uint32_t getBudgetUs() const { return budgetUs; }
+  uint8_t getLoad() const { return lastLoad; }
+  uint32_t getFrames() const { return totalFrames; }
+  uint32_t getOverruns() const { return totalOverruns; }
+  uint32_t getWorstUs() const { return worstUs; }
+  uint16_t getLevelChanges() const { return levelChanges; }
+
+  void resetStats() {
+    totalFrames = 0;
+    totalOverruns = 0;
+    worstUs = 0;
+    levelChanges = 0;
+  }
+
+  static const char* levelName(QosLevel l) {
+    switch (l) {
+      case QOS_NO_DEBUG:      return "no debug prints";
+      case QOS_NO_CONFIDENCE: return "no confidence";
+      case QOS_NO_DYNAMIC:    return "no dynamic gestures";
+      case QOS_REDUCED_RATE:  return "reduced output rate";
+      default:                return "full";
+    }
+  }
+};
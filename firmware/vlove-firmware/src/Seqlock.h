@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+
+// Single-writer, many-reader latest-value cell (seqlock)
+//
+// The writer bumps the sequence to odd, stores the value, bumps it back to
+// even. A reader copies the value into its own buffer and retries if the
+// sequence moved meanwhile. Neither side locks or allocates, and readers
+// never slow the writer down. The value is held as relaxed atomic words so
+// the overlapping copy is well-defined (and clean under ThreadSanitizer).
+// T must be trivially copyable.
+
+template <class T>
+class Seqlock {
+  static const uint32_t WORDS = (sizeof(T) + 3) / 4;
+
+private:
+  std::atomic<uint32_t> sequence;   // Odd while a write is in progress
+  std::atomic<uint32_t> words[WORDS];
+
+public:
+  Seqlock() : sequence(0) {
+    for (uint32_t i = 0; i < WORDS; i++) {
+      words[i].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  // Writer side (one thread only)
+  void write(const T& value) {
+    uint32_t buf[WORDS];
+    buf[WORDS - 1] = 0;
+    memcpy(buf, &value, sizeof(T));
+
+    uint32_t s = sequence.load(std::memory_order_relaxed);
+    sequence.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (uint32_t i = 0; i < WORDS; i++) {
+      words[i].store(buf[i], std::memory_order_relaxed);
+    }
+    sequence.store(s + 2, std::memory_order_release);
+  }
+
+  // Reader side: consistent copy of the latest value; returns its version
+  // (number of writes so far, 0 = never written)
+  uint32_t read(T& value) const {
+    uint32_t buf[WORDS];
+    uint32_t before, after;
+    do {
+      do {
+        before = sequence.load(std::memory_order_acquire);
+      } while (before & 1);
+      for (uint32_t i = 0; i < WORDS; i++) {
+        buf[i] = words[i].load(std::memory_order_relaxed);
+      }
+      std::atomic_thread_fence(std::memory_order_acquire);
+      after = sequence.load(std::memory_order_relaxed);
+    } while (before != after);
+
+    memcpy(&value, buf, sizeof(T));
+    return before >> 1;
+  }
+
+  uint32_t version() const { return sequence.load(std::memory_order_acquire) >> 1; }
+
+  // Copy only if written since version `seen`; updates `seen`
+  bool readIfNewer(T& value, uint32_t& seen) const {
+    if (version() == seen) return false;
+    seen = read(value);
+    return seen != 0;
+  }
+};
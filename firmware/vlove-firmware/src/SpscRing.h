@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+
+// Lock-free single-producer / single-consumer ring buffer
+//
+// One side (ISR, timer callback or task) only calls push(), the other only
+// pop()/peek(). Indices are free-running counters; the producer owns head,
+// the consumer owns tail, and acquire/release ordering makes a slot's
+// contents visible before its index. Safe across the two ESP32 cores.
+// When full, push() drops the new item and counts it instead of blocking.
+
+template <class T, uint32_t N>
+class SpscRing {
+  static_assert((N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+private:
+  T items[N];
+  std::atomic<uint32_t> head;      // Next slot to write (producer)
+  std::atomic<uint32_t> tail;      // Next slot to read (consumer)
+  std::atomic<uint32_t> dropped;   // Items rejected because the ring was full
+
+public:
+  SpscRing() : head(0), tail(0), dropped(0) {}
+
+  // Producer side
+  bool push(const T& item) {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) >= N) {
+      dropped.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    items[h & (N - 1)] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side
+  bool pop(T& item) {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == head.load(std::memory_order_acquire)) return false;
+    item = items[t & (N - 1)];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side: drop everything but the newest item and return it
+  bool popLatest(T& item) {
+    uint32_t h = head.load(std::memory_order_acquire);
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (t == h) return false;
+    item = items[(h - 1) & (N - 1)];
+    tail.store(h, std::memory_order_release);
+    return true;
+  }
+
+  uint32_t available() const {
+    return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+  }
+
+  uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+  static uint32_t capacity() { return N; }
+};
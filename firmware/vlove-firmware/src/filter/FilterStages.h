@@ -0,0 +1,383 @@
+#pragma once
+
+#include <Arduino.h>
+#include "../Config.h"
+#include "MedianFilter.h"
+#include "FixedPoint.h"
+#include "OneEuroFilter.h"
+#include "KalmanFilter.h"
+#include "NoiseEstimator.h"
+
+// Filter stages for Pipeline<Source, Stages...> (see Pipeline.h)
+//
+// A source provides:
+//   static int acquire(int pin, bool invert)   one raw reading of a pin
+// A stage derives from FilterStage and provides:
+//   int step(uint8_t ch, int x)                 process one sample of channel ch
+// and optionally hides reset() / setTimeStep() when it keeps state or needs
+// the sample period. All parameters are template arguments, so a stage
+// costs nothing beyond the work it does and unused stages are never built.
+
+#ifndef FILTER_CHANNELS
+#define FILTER_CHANNELS SENSOR_COUNT
+#endif
+
+struct FilterStage {
+  void reset() {}                 // Drop state; reseed from the next sample
+  void setTimeStep(float) {}      // Seconds since the previous frame
+};
+
+// ============ SOURCES ============
+
+// Average N analogRead() calls; optionally invert the pot polarity
+template <int N>
+struct Oversample {
+  static int acquire(int pin, bool invert) {
+    long sum = 0;
+    for (int i = 0; i < N; i++) {
+      sum += analogRead(pin);
+    }
+    int value = sum / N;
+    return invert ? ANALOG_MAX - value : value;
+  }
+};
+
+// ============ STAGES ============
+
+// Subtract a fixed offset from one channel (e.g. thumb baseline), clamp at 0
+template <int CH, int AMOUNT>
+struct ChannelOffset : FilterStage {
+  static int offset(uint8_t ch) { return ch == CH ? AMOUNT : 0; }
+
+  int step(uint8_t ch, int x) {
+    if (ch != CH) return x;
+    return (x > AMOUNT) ? x - AMOUNT : 0;
+  }
+};
+
+// Sliding-window median of N samples
+// After reset() the window is refilled with the next sample, so stale
+// values from before a mode switch never reach the output
+template <int N>
+class Median : public FilterStage {
+private:
+  MedianWindow<N> window[FILTER_CHANNELS];
+  bool initialized[FILTER_CHANNELS];
+
+public:
+  Median() { reset(); }
+
+  void reset() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      initialized[i] = false;
+    }
+  }
+
+  int step(uint8_t ch, int x) {
+    if (!initialized[ch]) {
+      window[ch].fill(x);
+      initialized[ch] = true;
+    } else {
+      window[ch].push(x);
+    }
+    return window[ch].median();
+  }
+};
+
+// Exponential moving average, Q15 alpha: Ema<Q15(0.3f)>
+template <int32_t ALPHA_Q15>
+class Ema : public FilterStage {
+private:
+  EmaQ15<ALPHA_Q15> ema[FILTER_CHANNELS];
+  bool initialized[FILTER_CHANNELS];
+
+public:
+  Ema() { reset(); }
+
+  void reset() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      initialized[i] = false;
+    }
+  }
+
+  int step(uint8_t ch, int x) {
+    if (!initialized[ch]) {
+      ema[ch].reset(x);
+      initialized[ch] = true;
+      return x;
+    }
+    return ema[ch].update(x);
+  }
+};
+
+// Same as Ema but computed in float (reference / FILTER_FLOAT_EMA builds)
+template <int32_t ALPHA_Q15>
+class FloatEma : public FilterStage {
+private:
+  float value[FILTER_CHANNELS];
+  bool initialized[FILTER_CHANNELS];
+
+public:
+  FloatEma() { reset(); }
+
+  void reset() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      initialized[i] = false;
+    }
+  }
+
+  int step(uint8_t ch, int x) {
+    const float alpha = (float)ALPHA_Q15 / Q15_ONE;
+    if (!initialized[ch]) {
+      value[ch] = x;
+      initialized[ch] = true;
+    } else {
+      value[ch] = alpha * x + (1.0f - alpha) * value[ch];
+    }
+    return (int)value[ch];
+  }
+};
+
+// Hold the output until the input moves more than WIDTH counts
+template <int WIDTH>
+class Deadzone : public FilterStage {
+private:
+  int last[FILTER_CHANNELS];
+  bool initialized[FILTER_CHANNELS];
+
+public:
+  Deadzone() { reset(); }
+
+  void reset() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      last[i] = 0;
+      initialized[i] = false;
+    }
+  }
+
+  int step(uint8_t ch, int x) {
+    if (!initialized[ch]) {
+      last[ch] = x;
+      initialized[ch] = true;
+      return x;
+    }
+    int diff = x - last[ch];
+    if (diff > WIDTH || diff < -WIDTH) {
+      last[ch] = x;
+    }
+    return last[ch];
+  }
+};
+
+// Noise-tuned EMA + deadzone
+// Each channel measures its own rest noise and derives its EMA alpha (to
+// reach AUTO_TUNE_TARGET_SIGMA at the output) and a deadzone just above the
+// remaining output noise. Clean channels get a fast alpha and a small
+// deadzone; noisy ones (the thumb) get more smoothing. Until a channel has
+// an estimate it uses the template defaults. reset() keeps the tuning: it
+// describes the sensor, not the current signal.
+#define AUTO_TUNE_TARGET_SIGMA  3.0f   // counts, desired output noise before deadzone
+#define AUTO_TUNE_ALPHA_MIN     0.1f
+#define AUTO_TUNE_ALPHA_MAX     0.8f
+#define AUTO_TUNE_DZ_SIGMAS     3.0f   // Deadzone width in output-noise sigmas
+#define AUTO_TUNE_DZ_MIN        4
+#define AUTO_TUNE_DZ_MAX        60
+#define AUTO_TUNE_INTERVAL      64     // Rest samples between retunes
+
+template <int32_t DEFAULT_ALPHA_Q15, int DEFAULT_DEADZONE>
+class AutoSmooth : public FilterStage {
+private:
+  NoiseEstimator noise[FILTER_CHANNELS];
+  EmaState ema[FILTER_CHANNELS];
+  int32_t alpha[FILTER_CHANNELS];
+  int deadzone[FILTER_CHANNELS];
+  int last[FILTER_CHANNELS];
+  bool initialized[FILTER_CHANNELS];
+  uint32_t tunedAt[FILTER_CHANNELS];   // Rest-sample count at last retune
+  float sigma[FILTER_CHANNELS];
+
+  void retune(uint8_t ch) {
+    float variance = noise[ch].variance();
+    sigma[ch] = sqrtf(variance);
+    noise[ch].setSigma(sigma[ch]);
+
+    // EMA output variance is variance * a / (2 - a); solve for the target
+    float a = AUTO_TUNE_ALPHA_MAX;
+    if (variance > 0) {
+      float r = AUTO_TUNE_TARGET_SIGMA * AUTO_TUNE_TARGET_SIGMA / variance;
+      a = 2.0f * r / (1.0f + r);
+    }
+    if (a < AUTO_TUNE_ALPHA_MIN) a = AUTO_TUNE_ALPHA_MIN;
+    if (a > AUTO_TUNE_ALPHA_MAX) a = AUTO_TUNE_ALPHA_MAX;
+    alpha[ch] = Q15(a);
+
+    float dz = AUTO_TUNE_DZ_SIGMAS * sigma[ch] * sqrtf(a / (2.0f - a));
+    if (dz < AUTO_TUNE_DZ_MIN) dz = AUTO_TUNE_DZ_MIN;
+    if (dz > AUTO_TUNE_DZ_MAX) dz = AUTO_TUNE_DZ_MAX;
+    deadzone[ch] = (int)(dz + 0.5f);
+
+    tunedAt[ch] = noise[ch].getRestSamples();
+  }
+
+public:
+  AutoSmooth() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      alpha[i] = DEFAULT_ALPHA_Q15;
+      deadzone[i] = DEFAULT_DEADZONE;
+      tunedAt[i] = 0;
+      sigma[i] = 0;
+    }
+    reset();
+  }
+
+  void reset() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      initialized[i] = false;
+    }
+  }
+
+  // Forget the measured noise and go back to the defaults
+  void retrain() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      noise[i].reset();
+      alpha[i] = DEFAULT_ALPHA_Q15;
+      deadzone[i] = DEFAULT_DEADZONE;
+      tunedAt[i] = 0;
+      sigma[i] = 0;
+    }
+  }
+
+  int step(uint8_t ch, int x) {
+    noise[ch].update(x);
+    if (noise[ch].hasEstimate() &&
+        noise[ch].getRestSamples() - tunedAt[ch] >= AUTO_TUNE_INTERVAL) {
+      retune(ch);
+    }
+
+    if (!initialized[ch]) {
+      ema[ch].reset(x);
+      last[ch] = x;
+      initialized[ch] = true;
+      return x;
+    }
+
+    int filtered = ema[ch].update(x, alpha[ch]);
+    int diff = filtered - last[ch];
+    if (diff > deadzone[ch] || diff < -deadzone[ch]) {
+      last[ch] = filtered;
+    }
+    return last[ch];
+  }
+
+  bool isTuned(uint8_t ch) const { return tunedAt[ch] > 0; }
+  float getSigma(uint8_t ch) const { return sigma[ch]; }
+  float getAlpha(uint8_t ch) const { return (float)alpha[ch] / Q15_ONE; }
+  int getDeadzone(uint8_t ch) const { return deadzone[ch]; }
+  bool isAtRest(uint8_t ch) const { return noise[ch].isAtRest(); }
+};
+
+// Speed-adaptive One-Euro low-pass, per-channel parameters set at runtime
+class OneEuro : public FilterStage {
+private:
+  OneEuroFilter filter[FILTER_CHANNELS];
+  OneEuroParams params[FILTER_CHANNELS];
+  float dt;
+
+public:
+  OneEuro() : dt(0) {
+    // Plain 1 Hz low-pass until configured with setParams()
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      params[i].minCutoff = 1.0f;
+      params[i].beta = 0.0f;
+      params[i].dCutoff = 1.0f;
+    }
+  }
+
+  void reset() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      filter[i].reset();
+    }
+  }
+
+  void setTimeStep(float seconds) { dt = seconds; }
+
+  int step(uint8_t ch, int x) {
+    return filter[ch].update(x, dt, params[ch]);
+  }
+
+  void setParams(uint8_t ch, const OneEuroParams& p) { params[ch] = p; }
+  const OneEuroParams& getParams(uint8_t ch) const { return params[ch]; }
+  float getSpeed(uint8_t ch) const { return filter[ch].getSpeed(); }
+};
+
+// Constant-velocity Kalman with latency-compensating prediction
+// Output is the position extrapolated leadMs ahead, clamped to the ADC range
+class Kalman : public FilterStage {
+private:
+  CvKalman filter[FILTER_CHANNELS];
+  KalmanParams params[FILTER_CHANNELS];
+  int32_t alpha[FILTER_CHANNELS];
+  int32_t beta[FILTER_CHANNELS];
+  float period;       // Sample period the gains were computed for (s)
+  float leadMs;
+  int32_t leadQ8;     // Lead in samples, 8 fractional bits
+
+  void updateGains() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      kalmanGains(params[i], period, &alpha[i], &beta[i]);
+    }
+    leadQ8 = (int32_t)(leadMs / 1000.0f / period * 256.0f);
+  }
+
+public:
+  Kalman() : period(0.01f), leadMs(0), leadQ8(0) {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      params[i].processNoise = 50000.0f;
+      params[i].measurementNoise = 8.0f;
+    }
+    updateGains();
+  }
+
+  void reset() {
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      filter[i].reset();
+    }
+  }
+
+  // Gains follow the real period; small jitter (<10%) is ignored and
+  // gaps (>0.5 s, e.g. after a pause) don't retune anything
+  void setTimeStep(float seconds) {
+    if (seconds <= 0 || seconds > 0.5f) return;
+    float change = seconds / period;
+    if (change > 0.9f && change < 1.1f) return;
+
+    for (int i = 0; i < FILTER_CHANNELS; i++) {
+      filter[i].rescaleVelocity(change);
+    }
+    period = seconds;
+    updateGains();
+  }
+
+  int step(uint8_t ch, int x) {
+    filter[ch].update(x, alpha[ch], beta[ch]);
+    int out = filter[ch].predict(leadQ8);
+    return (out < 0) ? 0 : (out > ANALOG_MAX ? ANALOG_MAX : out);
+  }
+
+  void setParams(uint8_t ch, const KalmanParams& p) {
+    params[ch] = p;
+    kalmanGains(params[ch], period, &alpha[ch], &beta[ch]);
+  }
+
+  void setLeadMs(float ms) {
+    leadMs = ms;
+    leadQ8 = (int32_t)(leadMs / 1000.0f / period * 256.0f);
+  }
+
+  float getLeadMs() const { return leadMs; }
+
+  // Estimated velocity in counts/s
+  float getVelocity(uint8_t ch) const {
+    return filter[ch].velocity() / (float)(1L << KALMAN_FRAC_BITS) / period;
+  }
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdint.h>
+
+// Fixed-point helpers for the per-sample filter path
+//
+// Coefficients are Q15 (1.0 == 32768) and converted at compile time, so the
+// filter stages only ever do integer multiply/shift/add. The arithmetic is
+// fully specified for 32/64-bit integers, which makes a host replay of a
+// recorded trace produce bit-identical output to the ESP32.
+
+#define Q15_SHIFT  15
+#define Q15_ONE    (1L << Q15_SHIFT)
+
+// Float -> Q15, rounded; usable as a template argument: EmaQ15<Q15(0.3f)>
+constexpr int32_t Q15(float x) {
+  return (int32_t)(x * (float)Q15_ONE + 0.5f);
+}
+
+// ============ EMA ============
+
+// Exponential moving average for one channel
+// State keeps EMA_FRAC_BITS of fraction so small steps are not lost to
+// truncation; output matches the float EMA (truncated to int) within 1 LSB.
+#define EMA_FRAC_BITS  16
+
+// Runtime alpha (for per-channel tuning)
+class EmaState {
+private:
+  int32_t state;  // value << EMA_FRAC_BITS
+
+public:
+  EmaState() : state(0) {}
+
+  void reset(int value) {
+    state = (int32_t)value << EMA_FRAC_BITS;
+  }
+
+  // state += alpha * (sample - state)
+  int update(int sample, int32_t alphaQ15) {
+    int32_t delta = ((int32_t)sample << EMA_FRAC_BITS) - state;
+    state += (int32_t)(((int64_t)delta * alphaQ15) >> Q15_SHIFT);
+    return value();
+  }
+
+  int value() const {
+    return (int)(state >> EMA_FRAC_BITS);
+  }
+};
+
+// Compile-time alpha: EmaQ15<Q15(0.3f)>
+template <int32_t ALPHA_Q15>
+class EmaQ15 {
+private:
+  EmaState ema;
+
+public:
+  void reset(int value) { ema.reset(value); }
+  int update(int sample) { return ema.update(sample, ALPHA_Q15); }
+  int value() const { return ema.value(); }
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stdint.h>
+#include <math.h>
+#include "FixedPoint.h"
+
+// Constant-velocity Kalman filter for one finger
+//
+// State is position and velocity. With a fixed sample period the Kalman
+// gains converge to constants, so the filter runs in its steady-state
+// (alpha-beta) form: the gains are computed once in float from the noise
+// parameters and period, and each sample costs two multiplies and a few
+// adds in fixed point. predict() extrapolates the state forward to hide
+// pipeline and link latency.
+
+struct KalmanParams {
+  float processNoise;      // counts/s^2, std-dev of finger acceleration
+  float measurementNoise;  // counts, std-dev of the sensor reading
+};
+
+#define KALMAN_FRAC_BITS  16
+
+// Steady-state gains for a CV model (Kalata): tracking index
+// lambda = processNoise * dt^2 / measurementNoise
+static inline void kalmanGains(const KalmanParams& p, float dt, int32_t* alphaQ15, int32_t* betaQ15) {
+  float lambda = p.processNoise * dt * dt / p.measurementNoise;
+  float r = (4.0f + lambda - sqrtf(8.0f * lambda + lambda * lambda)) / 4.0f;
+  float alpha = 1.0f - r * r;
+  float beta = 2.0f * (2.0f - alpha) - 4.0f * sqrtf(1.0f - alpha);
+  *alphaQ15 = Q15(alpha);
+  *betaQ15 = Q15(beta);
+}
+
+class CvKalman {
+private:
+  int32_t x;   // Position, counts << KALMAN_FRAC_BITS
+  int32_t v;   // Velocity, counts per sample << KALMAN_FRAC_BITS
+  bool initialized;
+
+public:
+  CvKalman() : x(0), v(0), initialized(false) {}
+
+  void reset() {
+    initialized = false;
+  }
+
+  void update(int z, int32_t alphaQ15, int32_t betaQ15) {
+    int32_t measured = (int32_t)z << KALMAN_FRAC_BITS;
+    if (!initialized) {
+      x = measured;
+      v = 0;
+      initialized = true;
+      return;
+    }
+
+    // Predict one sample ahead, then correct with the residual
+    int32_t predicted = x + v;
+    int32_t residual = measured - predicted;
+    x = predicted + (int32_t)(((int64_t)residual * alphaQ15) >> Q15_SHIFT);
+    v += (int32_t)(((int64_t)residual * betaQ15) >> Q15_SHIFT);
+  }
+
+  int position() const {
+    return (int)(x >> KALMAN_FRAC_BITS);
+  }
+
+  // Position extrapolated leadQ8 / 256 samples ahead
+  int predict(int32_t leadQ8) const {
+    int64_t ahead = (int64_t)x + (((int64_t)v * leadQ8) >> 8);
+    return (int)(ahead >> KALMAN_FRAC_BITS);
+  }
+
+  // Velocity in counts per sample, KALMAN_FRAC_BITS fraction
+  int32_t velocity() const { return v; }
+
+  // Keep velocity meaningful when the sample period changes
+  void rescaleVelocity(float ratio) {
+    v = (int32_t)(v * ratio);
+  }
+};
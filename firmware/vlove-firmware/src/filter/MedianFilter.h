@@ -0,0 +1,137 @@
+#pragma once
+
+#include <stdint.h>
+
+// Sliding-window median filter
+//
+// MedianWindow<N> keeps the last N samples twice: in arrival order (ring, to
+// know which sample to evict) and in sorted order. Each push removes the
+// oldest sample from the sorted array and slides the new one into place, so
+// reading the median is a single load of sorted[N / 2]. The cost per sample
+// is proportional to how far the value moved in rank, which for a slowly
+// moving finger is usually zero or one slot, instead of a full sort.
+//
+// Small windows (3 and 5) use a fixed min/max sorting network over the ring
+// instead, which is branch-free and needs no sorted copy.
+
+// ============ SORTING NETWORKS ============
+
+static inline int medianMin(int a, int b) { return a < b ? a : b; }
+static inline int medianMax(int a, int b) { return a < b ? b : a; }
+
+// Median of three: 3 compare/exchange
+static inline int median3(int a, int b, int c) {
+  return medianMax(medianMin(a, b), medianMin(medianMax(a, b), c));
+}
+
+// Median of five: the middle value of e and the two inner values of {a,b,c,d}
+static inline int median5(int a, int b, int c, int d, int e) {
+  int lo = medianMax(medianMin(a, b), medianMin(c, d));  // drops smallest of a-d
+  int hi = medianMin(medianMax(a, b), medianMax(c, d));  // drops largest of a-d
+  return median3(lo, hi, e);
+}
+
+// Compile-time selection: available = true when a network exists for N
+template <int N>
+struct MedianNetwork {
+  static const bool available = false;
+};
+
+template <>
+struct MedianNetwork<3> {
+  static const bool available = true;
+  static int median(const int* v) { return median3(v[0], v[1], v[2]); }
+};
+
+template <>
+struct MedianNetwork<5> {
+  static const bool available = true;
+  static int median(const int* v) { return median5(v[0], v[1], v[2], v[3], v[4]); }
+};
+
+// ============ MEDIAN WINDOW ============
+
+// Generic window: incrementally maintained sorted array
+template <int N, bool UseNetwork = MedianNetwork<N>::available>
+class MedianWindow {
+private:
+  int ring[N];     // Samples in arrival order
+  int sorted[N];   // Same samples, ascending
+  uint8_t head;    // Index of the oldest sample in ring
+
+  // Position of value in sorted (any match is fine, duplicates are equal)
+  int find(int value) const {
+    int lo = 0;
+    int hi = N - 1;
+    while (lo < hi) {
+      int mid = (lo + hi) / 2;
+      if (sorted[mid] < value) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return lo;
+  }
+
+public:
+  MedianWindow() { fill(0); }
+
+  // Set every slot to the same value
+  void fill(int value) {
+    for (int i = 0; i < N; i++) {
+      ring[i] = value;
+      sorted[i] = value;
+    }
+    head = 0;
+  }
+
+  // Replace the oldest sample with value
+  void push(int value) {
+    int oldest = ring[head];
+    ring[head] = value;
+    head = (head + 1 == N) ? 0 : head + 1;
+
+    // Slide the evicted slot towards the new value's rank
+    int pos = find(oldest);
+    if (value > oldest) {
+      while (pos + 1 < N && sorted[pos + 1] < value) {
+        sorted[pos] = sorted[pos + 1];
+        pos++;
+      }
+    } else {
+      while (pos > 0 && sorted[pos - 1] > value) {
+        sorted[pos] = sorted[pos - 1];
+        pos--;
+      }
+    }
+    sorted[pos] = value;
+  }
+
+  int median() const { return sorted[N / 2]; }
+};
+
+// Small window: ring only, median from the sorting network
+template <int N>
+class MedianWindow<N, true> {
+private:
+  int ring[N];
+  uint8_t head;
+
+public:
+  MedianWindow() { fill(0); }
+
+  void fill(int value) {
+    for (int i = 0; i < N; i++) {
+      ring[i] = value;
+    }
+    head = 0;
+  }
+
+  void push(int value) {
+    ring[head] = value;
+    head = (head + 1 == N) ? 0 : head + 1;
+  }
+
+  int median() const { return MedianNetwork<N>::median(ring); }
+};
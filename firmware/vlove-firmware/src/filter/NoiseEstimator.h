@@ -0,0 +1,89 @@
+#pragma once
+
+#include <stdint.h>
+
+// Per-channel sensor noise estimate, measured only while the finger rests
+//
+// A fast EMA tracks the local mean. A sample counts as "at rest" when it is
+// within a band around that mean (4 sigma, at least NOISE_REST_BAND_MIN);
+// after NOISE_REST_SAMPLES such samples in a row, the squared deviation
+// feeds a slow variance EMA. Movement resets the run, so curls and slow
+// drags don't inflate the estimate. Integer only per sample.
+
+#define NOISE_MEAN_SHIFT     3     // Local mean EMA: alpha = 1/8
+#define NOISE_VAR_SHIFT      6     // Variance EMA: alpha = 1/64
+#define NOISE_REST_SAMPLES   20    // Consecutive still samples before measuring
+#define NOISE_REST_BAND_MIN  32    // counts, rest band floor
+#define NOISE_MAX_DEVIATION  1000  // counts, clamp before squaring
+
+class NoiseEstimator {
+private:
+  int32_t meanQ8;        // Local mean, 8 fractional bits
+  uint32_t varianceQ8;   // Deviation variance, 8 fractional bits
+  uint16_t band;         // Current rest band (counts)
+  uint16_t stillCount;
+  uint32_t restSamples;  // Samples that contributed to the estimate
+  bool initialized;
+
+public:
+  NoiseEstimator() { reset(); }
+
+  void reset() {
+    meanQ8 = 0;
+    varianceQ8 = 0;
+    band = NOISE_REST_BAND_MIN;
+    stillCount = 0;
+    restSamples = 0;
+    initialized = false;
+  }
+
+  void update(int x) {
+    if (!initialized) {
+      meanQ8 = (int32_t)x << 8;
+      initialized = true;
+      return;
+    }
+
+    int32_t dev = x - (meanQ8 >> 8);
+    meanQ8 += (((int32_t)x << 8) - meanQ8) >> NOISE_MEAN_SHIFT;
+
+    if (dev > band || dev < -band) {
+      stillCount = 0;
+      return;
+    }
+    if (stillCount < NOISE_REST_SAMPLES) {
+      stillCount++;
+      return;
+    }
+
+    if (dev > NOISE_MAX_DEVIATION) dev = NOISE_MAX_DEVIATION;
+    if (dev < -NOISE_MAX_DEVIATION) dev = -NOISE_MAX_DEVIATION;
+    uint32_t sq = (uint32_t)(dev * dev) << 8;
+    if (sq > varianceQ8) {
+      varianceQ8 += (sq - varianceQ8) >> NOISE_VAR_SHIFT;
+    } else {
+      varianceQ8 -= (varianceQ8 - sq) >> NOISE_VAR_SHIFT;
+    }
+    restSamples++;
+  }
+
+  bool isAtRest() const { return stillCount >= NOISE_REST_SAMPLES; }
+
+  // Enough rest samples for the variance EMA to have settled
+  bool hasEstimate() const { return restSamples >= (1u << NOISE_VAR_SHIFT) * 2; }
+
+  uint32_t getRestSamples() const { return restSamples; }
+
+  // Noise variance in counts^2. Deviation from an EMA mean with alpha a has
+  // variance sigma^2 * 2 / (2 - a); undo that here.
+  float variance() const {
+    const float a = 1.0f / (1 << NOISE_MEAN_SHIFT);
+    return varianceQ8 / 256.0f * (2.0f - a) / 2.0f;
+  }
+
+  // Widen the rest band to 4 sigma once the noise is known
+  void setSigma(float sigma) {
+    float b = 4.0f * sigma;
+    band = (b > NOISE_REST_BAND_MIN) ? (uint16_t)b : NOISE_REST_BAND_MIN;
+  }
+};
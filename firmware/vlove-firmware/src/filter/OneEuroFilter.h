@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+
+// One-Euro filter (Casiez et al.): a first-order low-pass whose cutoff rises
+// with the signal's speed. At rest the cutoff sits at minCutoff and jitter is
+// smoothed away; when the finger moves fast the cutoff opens up by
+// beta * |speed| and lag drops. Positions are ADC counts, speed counts/s.
+
+struct OneEuroParams {
+  float minCutoff;  // Hz, cutoff at rest (lower = less jitter)
+  float beta;       // Hz per count/s, how fast the cutoff opens with speed
+  float dCutoff;    // Hz, cutoff used to smooth the speed estimate
+};
+
+class OneEuroFilter {
+private:
+  float x;          // Filtered position
+  float dx;         // Filtered speed (counts/s)
+  bool initialized;
+
+  // Smoothing factor of a first-order low-pass at cutoff Hz for step dt s
+  static float alpha(float cutoff, float dt) {
+    float tau = 1.0f / (6.2831853f * cutoff);
+    return 1.0f / (1.0f + tau / dt);
+  }
+
+public:
+  OneEuroFilter() : x(0), dx(0), initialized(false) {}
+
+  void reset() {
+    initialized = false;
+  }
+
+  int update(int sample, float dt, const OneEuroParams& params) {
+    if (!initialized || dt <= 0) {
+      x = sample;
+      dx = 0;
+      initialized = true;
+      return sample;
+    }
+
+    // Smoothed speed drives the position cutoff
+    float rawSpeed = (sample - x) / dt;
+    dx += alpha(params.dCutoff, dt) * (rawSpeed - dx);
+
+    float speed = dx < 0 ? -dx : dx;
+    float cutoff = params.minCutoff + params.beta * speed;
+    x += alpha(cutoff, dt) * (sample - x);
+
+    return (int)(x + 0.5f);
+  }
+
+  float getSpeed() const { return dx; }
+};
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <type_traits>
+#include "FilterStages.h"
+
+// Compile-time filter chain
+//
+//   typedef Pipeline<Oversample<4>, Median<5>, Ema<Q15(0.3f)>, Deadzone<15>> Chain;
+//
+// The first type is the source, the rest are stages applied in order. The
+// pipeline inherits every stage, so the whole chain is one object with no
+// virtual calls or runtime stage list; each step() is inlined into the next.
+// A stage type may appear only once per pipeline.
+
+// Type list used to walk the stages in declaration order
+template <class... S>
+struct StageList {};
+
+template <class Source, class... Stages>
+class Pipeline : public Stages... {
+private:
+  // Stage lookup by type; nullptr when the chain does not contain it
+  template <class S, bool Present>
+  struct Finder {
+    static S* get(Pipeline*) { return nullptr; }
+  };
+
+  template <class S>
+  struct Finder<S, true> {
+    static S* get(Pipeline* p) { return static_cast<S*>(p); }
+  };
+
+  int run(StageList<>, uint8_t, int x) { return x; }
+
+  template <class S, class... More>
+  int run(StageList<S, More...>, uint8_t ch, int x) {
+    return run(StageList<More...>(), ch, static_cast<S*>(this)->step(ch, x));
+  }
+
+public:
+  // Read pin through the source, then all stages
+  int read(uint8_t ch, int pin, bool invert) {
+    return process(ch, Source::acquire(pin, invert));
+  }
+
+  // Run an already-acquired sample through all stages
+  int process(uint8_t ch, int x) {
+    return run(StageList<Stages...>(), ch, x);
+  }
+
+  // Raw source reading, no stages
+  static int acquire(int pin, bool invert) {
+    return Source::acquire(pin, invert);
+  }
+
+  void reset() {
+    int expand[] = {0, (static_cast<Stages*>(this)->reset(), 0)...};
+    (void)expand;
+  }
+
+  void setTimeStep(float dt) {
+    int expand[] = {0, (static_cast<Stages*>(this)->setTimeStep(dt), 0)...};
+    (void)expand;
+  }
+
+  // Access a stage's own API, e.g. stage<OneEuro>()->setParams(...)
+  // Resolves at compile time; nullptr if S is not part of this chain
+  template <class S>
+  S* stage() {
+    return Finder<S, std::is_base_of<S, Pipeline>::value>::get(this);
+  }
+};
@@ -83,10 +83,9 @@ void DynamicMatcher::clearGestures() {
     gestureCount = 0;
 }
 
-bool DynamicMatcher::matchesPhase(const int* fingerPos, const DynamicPhase& phase) {
+bool DynamicMatcher::matchesPhase(const FingerPos* fingerPos, const DynamicPhase& phase) {
     for (int i = 0; i < NUM_FINGERS; i++) {
-        uint8_t normalizedValue = normalizeFingerPos(fingerPos[i]);
-        if (!matchesConstraint(normalizedValue, phase.fingers[i])) {
+        if (!matchesConstraint(fingerPos[i], phase.fingers[i])) {
             return false;
         }
     }
@@ -101,7 +100,7 @@ int8_t DynamicMatcher::getCurrentPhase(GestureId id) const {
     return -1;
 }
 
-GestureId DynamicMatcher::update(const int* fingerPos, uint16_t deltaTimeMs) {
+GestureId DynamicMatcher::update(const FingerPos* fingerPos, uint16_t deltaTimeMs) {
     GestureId completed = GESTURE_NONE;
 
     // Handle debounce
@@ -28,9 +28,9 @@ public:
     // Clear all registered gestures
     void clearGestures();
 
-    // Update state machine with current finger positions
+    // Update state machine with current finger positions (0-255)
     // Returns completed gesture ID or GESTURE_NONE
-    GestureId update(const int* fingerPos, uint16_t deltaTimeMs);
+    GestureId update(const FingerPos* fingerPos, uint16_t deltaTimeMs);
 
     // Reset all tracking state
     void reset();
@@ -54,7 +54,7 @@ private:
     uint16_t debounceTimeMs;
 
     // Helper methods
-    bool matchesPhase(const int* fingerPos, const DynamicPhase& phase);
+    bool matchesPhase(const FingerPos* fingerPos, const DynamicPhase& phase);
     int findGestureIndex(GestureId id) const;
     void resetTracker(uint8_t index);
 };
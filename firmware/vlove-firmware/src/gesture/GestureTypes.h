@@ -48,12 +48,12 @@ struct FingerConstraint {
 struct StaticGestureDef {
     GestureId id;                      // Gesture ID
     uint8_t priority;                  // Higher = checked first
-    FingerConstraint fingers[5];       // Constraints for each finger
+    FingerConstraint fingers[NUM_FINGERS];  // Constraints for each finger
 };
 
 // Dynamic gesture phase (18 bytes)
 struct DynamicPhase {
-    FingerConstraint fingers[5];       // Finger constraints for this phase
+    FingerConstraint fingers[NUM_FINGERS];  // Finger constraints for this phase
     uint16_t minDurationMs;            // Minimum time in this phase
     uint16_t maxDurationMs;            // Maximum time (0 = no limit)
     uint8_t nextPhase;                 // Next phase index (0xFF = complete)
@@ -7,7 +7,8 @@ StaticMatcher::StaticMatcher()
     , builtinCount(0)
     , customCount(0)
     , lastGesture(GESTURE_NONE)
-    , stableCount(0) {
+    , stableCount(0)
+    , debounceFrames(STATIC_DEBOUNCE_FRAMES) {
 }
 
 void StaticMatcher::begin(const StaticGestureDef* gestures, uint8_t count) {
@@ -21,7 +22,7 @@ void StaticMatcher::reset() {
     stableCount = 0;
 }
 
-uint8_t StaticMatcher::calculateConfidence(const int* fingerPos, const StaticGestureDef& gesture) {
+uint8_t StaticMatcher::calculateConfidence(const FingerPos* fingerPos, const StaticGestureDef& gesture) {
     uint16_t totalDist = 0;
     uint8_t checkedFingers = 0;
 
@@ -29,7 +30,7 @@ uint8_t StaticMatcher::calculateConfidence(const int* fingerPos, const StaticGes
         if (gesture.fingers[i].mode == CMP_ANY) continue;
 
         checkedFingers++;
-        uint8_t value = normalizeFingerPos(fingerPos[i]);
+        uint8_t value = fingerPos[i];
 
         // Calculate distance from target center
         uint8_t target = (gesture.fingers[i].min + gesture.fingers[i].max) / 2;
@@ -45,20 +46,20 @@ uint8_t StaticMatcher::calculateConfidence(const int* fingerPos, const StaticGes
     return 100 - (avgDist * 100 / 127);
 }
 
-bool StaticMatcher::matchesGesture(const int* fingerPos, const StaticGestureDef& gesture) {
+bool StaticMatcher::matchesGesture(const FingerPos* fingerPos, const StaticGestureDef& gesture) {
     for (int i = 0; i < NUM_FINGERS; i++) {
-        uint8_t normalizedValue = normalizeFingerPos(fingerPos[i]);
-        if (!matchesConstraint(normalizedValue, gesture.fingers[i])) {
+        if (!matchesConstraint(fingerPos[i], gesture.fingers[i])) {
             return false;
         }
     }
     return true;
 }
 
-GestureId StaticMatcher::match(const int* fingerPos, uint8_t* confidence) {
+GestureId StaticMatcher::match(const FingerPos* fingerPos, uint8_t* confidence) {
     GestureId bestMatch = GESTURE_NONE;
     uint8_t bestConfidence = 0;
     uint8_t bestPriority = 0;
+    bool scoring = (confidence != nullptr);  // Confidence only breaks priority ties
 
     // Check built-in gestures (from PROGMEM)
     for (uint8_t i = 0; i < builtinCount; i++) {
@@ -66,8 +67,8 @@ GestureId StaticMatcher::match(const int* fingerPos, uint8_t* confidence) {
         memcpy_P(&gesture, &builtinGestures[i], sizeof(StaticGestureDef));
 
         if (matchesGesture(fingerPos, gesture)) {
-            uint8_t conf = calculateConfidence(fingerPos, gesture);
-            if (gesture.priority > bestPriority ||
+            uint8_t conf = scoring ? calculateConfidence(fingerPos, gesture) : 0;
+            if (gesture.priority > bestPriority || (!scoring && bestMatch == GESTURE_NONE) ||
                 (gesture.priority == bestPriority && conf > bestConfidence)) {
                 bestMatch = gesture.id;
                 bestConfidence = conf;
@@ -81,8 +82,8 @@ GestureId StaticMatcher::match(const int* fingerPos, uint8_t* confidence) {
         const StaticGestureDef& gesture = customGestures[i];
 
         if (matchesGesture(fingerPos, gesture)) {
-            uint8_t conf = calculateConfidence(fingerPos, gesture);
-            if (gesture.priority > bestPriority ||
+            uint8_t conf = scoring ? calculateConfidence(fingerPos, gesture) : 0;
+            if (gesture.priority > bestPriority || (!scoring && bestMatch == GESTURE_NONE) ||
                 (gesture.priority == bestPriority && conf > bestConfidence)) {
                 bestMatch = gesture.id;
                 bestConfidence = conf;
@@ -91,7 +92,7 @@ GestureId StaticMatcher::match(const int* fingerPos, uint8_t* confidence) {
         }
     }
 
-    // Simple debounce: require stable match for DEBOUNCE_FRAMES
+    // Simple debounce: require stable match for debounceFrames
     if (bestMatch == lastGesture) {
         if (stableCount < 255) stableCount++;
     } else {
@@ -102,10 +103,10 @@ GestureId StaticMatcher::match(const int* fingerPos, uint8_t* confidence) {
     if (confidence) *confidence = bestConfidence;
 
     // Return gesture if stable enough
-    return (stableCount >= DEBOUNCE_FRAMES) ? bestMatch : GESTURE_NONE;
+    return (stableCount >= debounceFrames) ? bestMatch : GESTURE_NONE;
 }
 
-bool StaticMatcher::checkGesture(GestureId id, const int* fingerPos) {
+bool StaticMatcher::checkGesture(GestureId id, const FingerPos* fingerPos) {
     // Check built-in gestures
     for (uint8_t i = 0; i < builtinCount; i++) {
         StaticGestureDef gesture;
@@ -5,6 +5,9 @@
 // Maximum number of custom gestures
 #define MAX_CUSTOM_STATIC_GESTURES 16
 
+// Consecutive matches before a gesture is reported (default)
+#define STATIC_DEBOUNCE_FRAMES 2
+
 class StaticMatcher {
 public:
     StaticMatcher();
@@ -12,12 +15,12 @@ public:
     // Initialize with built-in gesture library
     void begin(const StaticGestureDef* gestures, uint8_t count);
 
-    // Match current finger positions against all gestures
-    // Returns gesture ID and sets confidence (0-100)
-    GestureId match(const int* fingerPos, uint8_t* confidence = nullptr);
+    // Match current finger positions (0-255, see normalizeFingerPos) against all gestures
+    // Returns gesture ID and sets confidence (0-100); pass nullptr to skip scoring
+    GestureId match(const FingerPos* fingerPos, uint8_t* confidence = nullptr);
 
     // Check if a specific gesture matches
-    bool checkGesture(GestureId id, const int* fingerPos);
+    bool checkGesture(GestureId id, const FingerPos* fingerPos);
 
     // Add custom gesture at runtime
     bool addCustomGesture(const StaticGestureDef& gesture);
@@ -35,6 +38,10 @@ public:
     // Reset debounce state
     void reset();
 
+    // Consecutive matches before a gesture is reported
+    void setDebounceFrames(uint8_t frames) { debounceFrames = frames > 0 ? frames : 1; }
+    uint8_t getDebounceFrames() const { return debounceFrames; }
+
 private:
     // Built-in gestures (stored in PROGMEM)
     const StaticGestureDef* builtinGestures;
@@ -47,9 +54,9 @@ private:
     // Debouncing state
     GestureId lastGesture;
     uint8_t stableCount;
-    static const uint8_t DEBOUNCE_FRAMES = 2;  // Minimal debounce
+    uint8_t debounceFrames;
 
     // Internal matching functions
-    uint8_t calculateConfidence(const int* fingerPos, const StaticGestureDef& gesture);
-    bool matchesGesture(const int* fingerPos, const StaticGestureDef& gesture);
+    uint8_t calculateConfidence(const FingerPos* fingerPos, const StaticGestureDef& gesture);
+    bool matchesGesture(const FingerPos* fingerPos, const StaticGestureDef& gesture);
 };
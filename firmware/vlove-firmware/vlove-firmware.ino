@@ -11,375 +11,991 @@
  */
 
 #include "src/Config.h"
+#include "src/Logger.h"
 #include "src/Calibration.h"
-#include "src/GestureRecognizer.h"
-#include "src/AirPiano.h"
 #include "src/Communication.h"
 #include "src/AnalogFilter.h"
+#include "src/FingerFeatures.h"
+#include "src/AcquisitionTask.h"
+#include "src/FingerFrame.h"
+#include "src/Events.h"
+#include "src/Profiler.h"
+#include "src/Qos.h"
+#include "src/PowerScheduler.h"
+#include "src/Params.h"
+#include "src/CommandLine.h"
+
+#ifdef ENABLE_GESTURES
+#include "src/GestureRecognizer.h"
+#endif
+
+#ifdef ENABLE_PIANO
+#include "src/AirPiano.h"
+#endif
 
 #ifdef ENABLE_IMU
 #include "src/IMU.h"
 #endif
 
 // Global objects
+Logger logger;   // Human-readable output, written by a background task
 Calibration calibration;
-GestureRecognizer gestureRecognizer;
-AirPiano airPiano;
 Communication comm;
 AnalogFilter analogFilter;
+FingerFeatures fingerFeatures;
+AcquisitionTask acquisition(analogFilter);
+QosGovernor qos;
+PowerScheduler power(acquisition, analogFilter);
+ParamRegistry params;
+CommandLine commandLine;
+FingerFrame frames[STREAM_COUNT];   // Latest frame of each stream, as consumers see it
+EventBus events;                    // Gesture and note changes (see sendEvent/logEvent)
+#ifdef ENABLE_PROFILER
+Profiler profiler;
+#endif
+
+#ifdef ENABLE_GESTURES
+GestureRecognizer gestureRecognizer;
+#endif
+
+#ifdef ENABLE_PIANO
+AirPiano airPiano;
+#endif
 
 #ifdef ENABLE_IMU
 IMU imu;
 bool imuEnabled = false;
 #endif
 
-// Finger data
-int rawFingers[5];
-int mappedFingers[5];
+// Consumers that can run side by side, each on its own stream
+#define CONSUMER_GESTURE     0x01
+#define CONSUMER_PIANO       0x02
+#define CONSUMER_OPENGLOVES  0x04
+#define CONSUMER_RAW         0x08
+
+// Stream OpenGloves alongside the current mode (VR+)
+bool vrOverlay = false;
 
 // Timing
 unsigned long lastOutputTime = 0;
+unsigned long bootMs = 0;        // setup() done
+unsigned long firstFrameMs = 0;  // First frame handled by a consumer
 
 void setup() {
   // Initialize serial for debugging (always on)
   Serial.begin(BAUD_RATE);
-  delay(1000);
-
-  // Print banner
-  Serial.println();
-  Serial.println("****************************************");
-  Serial.println("*            VLOVE v2.0               *");
-  Serial.println("*   Gesture Recognition & Air Piano   *");
-  Serial.println("*     + OpenGloves + IMU Support      *");
-  Serial.println("****************************************");
-  Serial.println();
+  logger.begin();
+  #ifndef ENABLE_FAST_BOOT
+  delay(1000);     // Give the serial monitor time to attach
+  printBanner();
+  #endif
 
   // Initialize communication
   comm.begin();
 
   // Initialize analog filter
   analogFilter.begin();
-  Serial.println("Analog filter initialized.");
+  logger.println("Analog filter initialized.");
 
   // Initialize IMU
   #ifdef ENABLE_IMU
-  Serial.println("Initializing IMU...");
+  logger.println("Initializing IMU...");
   imuEnabled = imu.begin(PIN_IMU_SDA, PIN_IMU_SCL);
   if (imuEnabled) {
-    Serial.println("IMU ready. Calibrating gyro...");
-    imu.calibrate(200);
+    bool restored = false;
+    #ifdef ENABLE_FAST_BOOT
+    restored = imu.loadOffsets();   // Bias keeps being refined while the hand is still
+    #endif
+    if (restored) {
+      logger.println("IMU ready (stored offsets).");
+    } else {
+      logger.println("IMU ready. Calibrating gyro...");
+      imu.calibrate(200);
+    }
   }
   #endif
 
+  // Recognition results go out as they change
+  events.subscribe(sendEvent);
+  events.subscribe(logEvent);
+
+  #ifdef ENABLE_PIANO
+  // Note velocity from curl speed
+  airPiano.setFeatures(&fingerFeatures);
+  airPiano.setEventBus(&events);
+  #endif
+
+  #ifdef ENABLE_GESTURES
   // Initialize gesture recognizer
   gestureRecognizer.begin();
-  Serial.println("Gesture recognizer initialized (static + dynamic).");
+  gestureRecognizer.setEventBus(&events);
+  logger.println("Gesture recognizer initialized (static + dynamic).");
+  #endif
 
-  // Initialize calibration
+  // Initialize calibration (computes the raw -> position scale factors)
+  for (int i = 0; i < SENSOR_COUNT; i++) {
+    calibration.setInputTransform(i, analogFilter.isInverted(i), analogFilter.getInputOffset(i));
+  }
   calibration.begin();
 
+  // Field-tuned constants (SET / SAVE)
+  int restored = params.load();
+  if (restored > 0) {
+    logger.println("Loaded %d saved parameters.", restored);
+  }
+  applyParams();
+
   // Check for saved calibration
   if (calibration.hasValidCalibration) {
-    Serial.println("Loaded calibration from EEPROM.");
-    Serial.println();
-    printHelp();
+    logger.println("Loaded calibration from EEPROM.");
   } else {
-    Serial.println("No calibration found. Starting calibration...");
+    logger.println("No calibration found. Starting calibration...");
     calibration.startCalibration();
   }
+
+  // Start sampling + filtering (own core with ENABLE_DUAL_CORE)
+  if (!acquisition.begin()) {
+    logger.println("Acquisition task failed to start!");
+  }
+
+  bootMs = millis();
+  #ifndef ENABLE_FAST_BOOT
+  printStartup();
+  #endif
 }
 
 void loop() {
+  uint32_t frameStart = micros();
+  PROFILE_START(loopStart);
+
   // Handle serial commands
   handleCommands();
 
-  // Update IMU
-  #ifdef ENABLE_IMU
-  if (imuEnabled) {
-    imu.update();
+  // One acquisition feeds every active consumer at its own rate
+  uint8_t consumers = activeConsumers();
+  uint8_t streams = streamsFor(consumers);
+  acquisition.setStreams(streams);
+  applyPowerPolicy(consumers);
+
+  bool worked;
+  if (calibration.isCalibrating) {
+    worked = processCalibration();  // Don't process gestures during calibration
+  } else {
+    worked = updateFeatures(consumers);
+    #ifdef ENABLE_PIANO
+    if (consumers & CONSUMER_PIANO)      worked |= processPianoMode();
+    #endif
+    #ifdef ENABLE_GESTURES
+    if (consumers & CONSUMER_GESTURE)    worked |= processGestureMode();
+    #endif
+    #ifdef ENABLE_OPENGLOVES
+    if (consumers & CONSUMER_OPENGLOVES) worked |= processOpenGlovesMode();
+    #endif
+    if (consumers & CONSUMER_RAW)        worked |= processRawMode();
+  }
+
+  power.update(millis(), fingerFeatures.isQuiescent());
+
+  if (worked && firstFrameMs == 0) {
+    firstFrameMs = millis();
+  }
+
+  #ifdef ENABLE_FAST_BOOT
+  // Startup text waits until frames are flowing
+  static bool announced = false;
+  if (!announced && (firstFrameMs || millis() - bootMs >= FAST_BOOT_QUIET_MS)) {
+    announced = true;
+    printBanner();
+    printStartup();
   }
   #endif
 
-  // Read finger values with filtering
-  analogFilter.readFiltered(rawFingers);
+  if (worked) {
+    // Budget is the period of the fastest stream being consumed
+    qos.setFramePeriodUs(1000000UL / analogFilter.getRate(acquisition.fastestStream(streams)));
+    qos.record(micros() - frameStart);
+    PROFILE_STOP(loopStart, PROF_LOOP);
+  } else if (power.isIdle()) {
+    logger.service();
+    power.sleep();       // Sampling paused; probe for motion now and then
+  } else {
+    logger.service();
+    acquisition.wait();  // No new frame for anyone yet
+  }
 
-  // Update calibration if active
-  if (calibration.isCalibrating) {
-    calibration.update(rawFingers);
+  if (qos.update(millis())) {
+    applyQos();
+  }
+}
 
-    // Print calibration status
-    static unsigned long lastCalibPrint = 0;
-    if (millis() - lastCalibPrint >= 300) {
-      lastCalibPrint = millis();
-      calibration.printStatus(rawFingers);
-    }
-    return;  // Don't process gestures during calibration
+void printBanner() {
+  #ifdef ENABLE_HELP_TEXT
+  logger.println();
+  logger.println("****************************************");
+  logger.println("*            VLOVE v2.0               *");
+  logger.println("*   Gesture Recognition & Air Piano   *");
+  logger.println("*     + OpenGloves + IMU Support      *");
+  logger.println("****************************************");
+  logger.println();
+  #else
+  logger.println("VLOVE v2.0 (%s)", VLOVE_PROFILE_NAME);
+  #endif
+}
+
+// Help (once calibrated) and the build report
+void printStartup() {
+  if (calibration.hasValidCalibration && !calibration.isCalibrating) {
+    logger.println();
+    printHelp();
   }
+  printBuild();
+}
 
-  // Map finger values using calibration
-  for (int i = 0; i < 5; i++) {
-    mappedFingers[i] = calibration.mapValue(i, rawFingers[i]);
+// Shed or restore optional work after a QoS level change
+void applyQos() {
+  #ifdef ENABLE_GESTURES
+  gestureRecognizer.setConfidenceEnabled(!qos.sheds(QOS_NO_CONFIDENCE));
+  gestureRecognizer.setDynamicEnabled(!qos.sheds(QOS_NO_DYNAMIC));
+  #endif
+  logger.println("QoS: level %d (%s), load %d%%", qos.getLevel(),
+                 QosGovernor::levelName(qos.getLevel()), qos.getLoad());
+}
+
+// CPU clock and idling for the current mode
+void applyPowerPolicy(uint8_t consumers) {
+  #ifdef ENABLE_POWER_SAVE
+  power.setLightSleep(!comm.isBluetoothEnabled());
+  if (calibration.isCalibrating) {
+    power.setPolicy(POWER_ACTIVE_MHZ, POWER_IDLE_NEVER);
+  } else if (consumers == 0) {
+    power.setPolicy(POWER_LOW_MHZ, POWER_IDLE_ALWAYS);         // HOME: nothing to sample for
+  } else if (consumers & CONSUMER_OPENGLOVES) {
+    power.setPolicy(POWER_ACTIVE_MHZ, POWER_IDLE_NEVER);       // SteamVR expects a steady stream
+  } else if (consumers == CONSUMER_RAW) {
+    power.setPolicy(POWER_LOW_MHZ, POWER_IDLE_NEVER);          // One line per 100 ms
+  } else {
+    power.setPolicy(POWER_ACTIVE_MHZ, POWER_IDLE_WHEN_STILL);  // Gestures, piano
   }
+  #else
+  (void)consumers;
+  #endif
+}
 
-  // Process based on current mode
+// Consumers of the current mode, plus the OpenGloves overlay
+uint8_t activeConsumers() {
+  uint8_t consumers = 0;
   switch (currentMode) {
-    case MODE_HOME:
-      // Paused - do nothing, wait for commands
-      break;
     case MODE_GESTURE:
-      processGestureMode();
+      consumers = CONSUMER_GESTURE;
       break;
     case MODE_PIANO_SINGLE:
     case MODE_PIANO_PITCH:
     case MODE_PIANO_CHORD:
-      processPianoMode();
+      consumers = CONSUMER_PIANO;
       break;
     case MODE_RAW:
-      processRawMode();
+      consumers = CONSUMER_RAW;
       break;
     case MODE_OPENGLOVES:
-      processOpenGlovesMode();
+      consumers = CONSUMER_OPENGLOVES;
       break;
+    default:
+      break;  // HOME: paused
   }
+  if (vrOverlay) {
+    consumers |= CONSUMER_OPENGLOVES;
+  }
+  return consumers;
+}
+
+// Piano onsets get every frame; gestures and the host link get decimated
+// streams so they cost less CPU
+uint8_t streamsFor(uint8_t consumers) {
+  if (calibration.isCalibrating) {
+    return STREAM_BIT(STREAM_GESTURE);
+  }
+  uint8_t streams = 0;
+  if (consumers & CONSUMER_PIANO) streams |= STREAM_BIT(STREAM_FULL);
+  if (consumers & CONSUMER_GESTURE) streams |= STREAM_BIT(STREAM_GESTURE);
+  if (consumers & (CONSUMER_OPENGLOVES | CONSUMER_RAW)) streams |= STREAM_BIT(STREAM_HOST);
+  return streams;
+}
+
+// Latest frame of a stream if it is newer than `seen` (updated), else nullptr
+// Calibration runs once per published frame, for whichever consumer asks
+// first; the others on the same stream share the result
+const FingerFrame* nextFrame(SampleStream s, uint32_t& seen) {
+  FingerFrame& frame = frames[s];
+  uint32_t version = frame.seq;
+  FilteredFrame filtered;
+  if (acquisition.read(s, filtered, version)) {
+    PROFILE_SCOPE(PROF_FRAME);
+    frame.timestampUs = filtered.timestampUs;
+    frame.seq = version;
+    frame.intervalMs = filtered.intervalMs;
+    frame.stream = (uint8_t)s;
+#ifdef ENABLE_IMU
+    frame.hasOrientation = false;
+#endif
+    for (int i = 0; i < SENSOR_COUNT; i++) {
+      frame.raw[i] = (int16_t)filtered.value[i];
+    }
+    calibration.mapFrame(filtered.value, frame.position, frame.normalized);
+    for (int i = 0; i < FINGER_COUNT; i++) {
+      frame.onset[i] = (int16_t)calibration.mapValue(i, filtered.onset[i]);
+    }
+  }
+  if (frame.seq == seen) {
+    return nullptr;
+  }
+  seen = frame.seq;
+  return &frame;
+}
 
-  delay(LOOP_DELAY_MS);
+bool processCalibration() {
+  static uint32_t version = 0;
+  FilteredFrame frame;
+  if (!acquisition.read(STREAM_GESTURE, frame, version)) {
+    return false;
+  }
+
+  calibration.update(frame.value);
+
+  // Print calibration status
+  static unsigned long lastCalibPrint = 0;
+  if (millis() - lastCalibPrint >= 300) {
+    lastCalibPrint = millis();
+    calibration.printStatus(frame.value);
+  }
+  return true;
 }
 
+// Motion features (velocity, spread, stillness) at the fastest active rate
+bool updateFeatures(uint8_t consumers) {
+  static uint32_t version = 0;
+  static SampleStream lastStream = STREAM_GESTURE;
+  SampleStream s = acquisition.fastestStream(streamsFor(consumers));
+  if (s != lastStream) {
+    lastStream = s;
+    version = 0;
+  }
+
+  const FingerFrame* frame = nextFrame(s, version);
+  if (!frame) {
+    return false;
+  }
+
+  PROFILE_SCOPE(PROF_FEATURES);
+  fingerFeatures.setRate(analogFilter.getRate(s));
+  fingerFeatures.update(frame->position);
+  return true;
+}
+
+// Recognition events to the host link: each gesture once when it begins,
+// notes as they change
+void sendEvent(const GloveEvent& event, void*) {
+  PROFILE_SCOPE(PROF_COMM);
+  TraceStamp stamp = {event.seq, event.timestampUs};
+  switch (event.type) {
+    #ifdef ENABLE_GESTURES
+    case EVENT_STATIC_BEGIN:
+    case EVENT_DYNAMIC:
+      comm.sendGesture(event.gesture, gestureRecognizer.getGestureName(event.gesture), &stamp);
+      break;
+    #endif
+    case EVENT_NOTE_ON:
+    case EVENT_NOTE_OFF:
+    case EVENT_PITCH_BEND:
+      comm.sendPianoEvent(event.piano, &stamp);
+      break;
+    default:
+      break;
+  }
+}
+
+// Recognition events to the console (dropped first under load)
+void logEvent(const GloveEvent& event, void*) {
+  if (qos.sheds(QOS_NO_DEBUG)) {
+    return;
+  }
+  switch (event.type) {
+    #ifdef ENABLE_GESTURES
+    case EVENT_STATIC_BEGIN:
+      logger.println("Gesture: %s (%d%%)", gestureRecognizer.getGestureName(event.gesture), event.confidence);
+      break;
+    case EVENT_STATIC_END:
+      logger.println("Gesture: %s ended", gestureRecognizer.getGestureName(event.gesture));
+      break;
+    case EVENT_DYNAMIC:
+      logger.println("Dynamic: %s", gestureRecognizer.getGestureName(event.gesture));
+      break;
+    #endif
+    case EVENT_NOTE_ON:
+    case EVENT_NOTE_OFF:
+      logger.println("Piano: %s note=%d vel=%d",
+                     event.type == EVENT_NOTE_ON ? "ON " : "OFF", event.piano.note, event.piano.velocity);
+      break;
+    case EVENT_PITCH_BEND:
+      logger.println("Piano: BEND note=%d bend=%d", event.piano.note, event.piano.pitchBend);
+      break;
+    default:
+      break;
+  }
+}
+
+#ifdef ENABLE_GESTURES
 // Debug flag for gesture recognition
 bool gestureDebug = false;
 
 // Gesture display interval (ms)
 #define GESTURE_DISPLAY_INTERVAL 200
 
-void processGestureMode() {
-  static GestureId lastSentGesture = GESTURE_NONE;
+bool processGestureMode() {
+  static uint32_t version = 0;
   static unsigned long lastDisplayTime = 0;
 
-  // Use extended recognition for static + dynamic gestures
-  GestureResult result = gestureRecognizer.recognizeEx(mappedFingers, LOOP_DELAY_MS);
+  const FingerFrame* frame = nextFrame(STREAM_GESTURE, version);
+  if (!frame) {
+    return false;
+  }
 
-  // Display gesture every GESTURE_DISPLAY_INTERVAL ms
-  if (millis() - lastDisplayTime >= GESTURE_DISPLAY_INTERVAL) {
+  // Static + dynamic recognition; changes go out as events
+  {
+    PROFILE_SCOPE(PROF_GESTURE);
+    gestureRecognizer.recognizeEx(*frame);
+  }
+
+  // Debug: finger values and the held gesture every GESTURE_DISPLAY_INTERVAL ms
+  if (gestureDebug && !qos.sheds(QOS_NO_DEBUG) &&
+      millis() - lastDisplayTime >= GESTURE_DISPLAY_INTERVAL) {
     lastDisplayTime = millis();
+    const uint8_t* n = frame->normalized;
+    GestureId held = gestureRecognizer.getLastStaticGesture();
+    logger.println("Fingers[0-255]: %d %d %d %d %d  -> %s (%d%%)", n[0], n[1], n[2], n[3], n[4],
+                   held != GESTURE_NONE ? gestureRecognizer.getGestureName(held) : "None",
+                   gestureRecognizer.getLastConfidence());
+  }
+  return true;
+}
+#endif
 
-    // Debug: show finger values
-    if (gestureDebug) {
-      Serial.print("Fingers[0-255]: ");
-      for (int i = 0; i < 5; i++) {
-        uint8_t normalized = (uint8_t)((long)mappedFingers[i] * 255 / 4095);
-        Serial.print(normalized);
-        Serial.print(" ");
-      }
-      Serial.print(" -> ");
-    }
+#ifdef ENABLE_PIANO
+bool processPianoMode() {
+  static uint32_t version = 0;
+  const FingerFrame* frame = nextFrame(STREAM_FULL, version);
+  if (!frame) {
+    return false;
+  }
 
-    // Always show current gesture
-    if (result.staticGesture != GESTURE_NONE) {
-      Serial.print("Gesture: ");
-      Serial.print(gestureRecognizer.getGestureName(result.staticGesture));
-      Serial.print(" (");
-      Serial.print(result.confidence);
-      Serial.println("%)");
-
-      // Send to comm if changed
-      if (result.staticGesture != lastSentGesture) {
-        comm.sendGesture(result.staticGesture, gestureRecognizer.getGestureName(result.staticGesture));
-        lastSentGesture = result.staticGesture;
-      }
-    } else {
-      Serial.println("Gesture: None");
-    }
+  // Note triggers use the fast onset path; velocity and pitch the smooth one.
+  // Changes go out as events
+  PROFILE_SCOPE(PROF_PIANO);
+  airPiano.process(*frame, currentMode);
+  return true;
+}
+#endif
+
+bool processRawMode() {
+  static uint32_t version = 0;
+  static unsigned long lastRawPrint = 0;
+  const FingerFrame* frame = nextFrame(STREAM_HOST, version);
+  if (!frame) {
+    return false;
   }
 
-  // Handle dynamic gestures (always report when detected)
-  if (result.isNewDynamic && result.dynamicGesture != GESTURE_NONE) {
-    comm.sendGesture(result.dynamicGesture, gestureRecognizer.getGestureName(result.dynamicGesture));
-    Serial.print("Dynamic: ");
-    Serial.println(gestureRecognizer.getGestureName(result.dynamicGesture));
+  if (millis() - lastRawPrint >= 100) {
+    lastRawPrint = millis();
+    PROFILE_SCOPE(PROF_COMM);
+    comm.sendRawData(*frame);
   }
+  return true;
 }
 
-void processPianoMode() {
-  PianoEvent event = airPiano.process(mappedFingers, currentMode);
+#ifdef ENABLE_OPENGLOVES
+bool processOpenGlovesMode() {
+  // Runs at HOST_RATE_HZ for smooth tracking
+  static uint32_t version = 0;
+  const FingerFrame* frame = nextFrame(STREAM_HOST, version);
+  if (!frame) {
+    return false;
+  }
+  // Under load, send one frame in QOS_RATE_DIVIDER
+  if (qos.sheds(QOS_REDUCED_RATE) && version % QOS_RATE_DIVIDER != 0) {
+    return true;
+  }
 
-  if (event.hasEvent) {
-    comm.sendPianoEvent(event);
+  #ifdef ENABLE_IMU
+  if (imuEnabled) {
+    imu.update();
+    FingerFrame withOrientation = *frame;
+    withOrientation.hasOrientation = true;
+    withOrientation.orientation = imu.getQuaternion();
+    PROFILE_SCOPE(PROF_COMM);
+    comm.sendOpenGloves(withOrientation);
+    return true;
+  }
+  #endif
+  PROFILE_SCOPE(PROF_COMM);
+  comm.sendOpenGloves(*frame);
+  return true;
+}
+#endif
 
-    Serial.print("Piano: ");
-    if (event.type == PIANO_NOTE_ON) {
-      Serial.print("ON  ");
+// Mode switch messages
+const char* modeDescription(OperationMode mode) {
+  switch (mode) {
+    case MODE_GESTURE:      return "GESTURE RECOGNITION";
+    case MODE_PIANO_SINGLE: return "PIANO - Single Notes (one finger = one note)";
+    case MODE_PIANO_PITCH:  return "PIANO - Pitch Control (bend = pitch)";
+    case MODE_PIANO_CHORD:  return "PIANO - Chord Mode";
+    case MODE_RAW:          return "RAW DATA";
+    case MODE_OPENGLOVES:   return "OPENGLOVES (SteamVR)";
+    default:                return "HOME (Paused)";
+  }
+}
+
+// ============ COMMAND HANDLERS ============
+// option = CommandDef::option (the mode for cmdMode)
+
+void cmdCalibrate(const CommandArgs&, int) {
+  calibration.startCalibration();
+}
+
+void cmdStopCalibration(const CommandArgs&, int) {
+  if (calibration.isCalibrating) {
+    calibration.stopCalibration();
+    printHelp();
+  }
+}
+
+void cmdClear(const CommandArgs&, int) {
+  calibration.clearEEPROM();
+  logger.println("EEPROM cleared.");
+  calibration.startCalibration();
+}
+
+#ifdef ENABLE_GESTURES
+void cmdDebug(const CommandArgs&, int) {
+  gestureDebug = !gestureDebug;
+  logger.println("Gesture debug: %s", gestureDebug ? "ON" : "OFF");
+}
+#endif
+
+void cmdMode(const CommandArgs&, int mode) {
+  currentMode = (OperationMode)mode;
+  logger.println("Mode: %s", modeDescription(currentMode));
+  if (currentMode == MODE_HOME) {
+    printHelp();
+  } else if (currentMode == MODE_OPENGLOVES) {
+    #ifdef ENABLE_IMU
+    if (imuEnabled) {
+      logger.println("  IMU: Enabled - sending orientation data");
     } else {
-      Serial.print("OFF ");
+      logger.println("  IMU: Not available - fingers only");
     }
-    Serial.print("note=");
-    Serial.print(event.note);
-    Serial.print(" vel=");
-    Serial.println(event.velocity);
+    #else
+    logger.println("  IMU: Disabled in Config.h");
+    #endif
   }
 }
 
-void processRawMode() {
-  static unsigned long lastRawPrint = 0;
-  if (millis() - lastRawPrint >= 100) {
-    lastRawPrint = millis();
-    comm.sendRawData(rawFingers, mappedFingers);
-  }
+#ifdef ENABLE_OPENGLOVES
+void cmdOverlay(const CommandArgs&, int) {
+  vrOverlay = !vrOverlay;
+  logger.println("OpenGloves alongside current mode: %s", vrOverlay ? "ON" : "OFF");
 }
+#endif
 
-void processOpenGlovesMode() {
-  // Send at ~100Hz for smooth tracking
+void cmdImu(const CommandArgs&, int) {
   #ifdef ENABLE_IMU
   if (imuEnabled) {
-    Quaternion q = imu.getQuaternion();
-    comm.sendOpenGlovesWithIMU(mappedFingers, q.w, q.x, q.y, q.z);
+    imu.update();  // Only the OpenGloves consumer keeps it running
+    imu.printData();
   } else {
-    comm.sendOpenGloves(mappedFingers);
+    logger.println("IMU not initialized. Check wiring.");
   }
   #else
-  comm.sendOpenGloves(mappedFingers);
+  logger.println("IMU disabled in Config.h");
   #endif
 }
 
-void handleCommands() {
-  static String cmdBuffer = "";
+void cmdImuCalibrate(const CommandArgs&, int) {
+  #ifdef ENABLE_IMU
+  if (imuEnabled) {
+    logger.println("Calibrating IMU... Keep device still!");
+    imu.calibrate(500);
+  }
+  #endif
+}
 
-  while (Serial.available()) {
-    char c = Serial.read();
+#ifdef FILTER_PROFILE_FULL
+void cmdFilter(const CommandArgs&, int) {
+  FilterMode next = (FilterMode)((acquisition.getFilterMode() + 1) % FILTER_MODE_COUNT);
+  acquisition.setFilterMode(next);
+  logger.println("Filter: %s", AnalogFilter::modeName(next));
+}
+#endif
 
-    if (c == '\n' || c == '\r') {
-      if (cmdBuffer.length() > 0) {
-        processCommand(cmdBuffer);
-        cmdBuffer = "";
-      }
-    } else {
-      cmdBuffer += c;
-    }
+void cmdQos(const CommandArgs&, int)      { printQos(); }
+
+// STATS [RESET]
+void cmdStats(const CommandArgs& args, int) {
+  printStats(args.count > 1 && strcasecmp(args.word[1], "RESET") == 0);
+}
+void cmdPower(const CommandArgs&, int)    { printPower(); }
+void cmdNoise(const CommandArgs&, int)    { printNoise(); }
+void cmdFeatures(const CommandArgs&, int) { printFeatures(); }
+void cmdHelp(const CommandArgs&, int)     { printHelp(); }
+void cmdBuild(const CommandArgs&, int)    { printBuild(); }
+
+void cmdBluetooth(const CommandArgs&, int) {
+  comm.toggleBluetooth();
+}
+
+// TRACE [ON|OFF] - toggles without an argument
+void cmdTrace(const CommandArgs& args, int) {
+  bool on = !comm.isTracing();
+  if (args.count > 1) {
+    on = strcasecmp(args.word[1], "OFF") != 0;
   }
+  comm.setTrace(on);
+  logger.println("Trace: %s", on ? "ON (@line,seq,capture_us on every message)" : "OFF");
 }
 
-void processCommand(String cmd) {
-  cmd.trim();
-  cmd.toUpperCase();
+void cmdSync(const CommandArgs&, int)     { comm.sendSync(); }
 
-  if (cmd == "CAL") {
-    calibration.startCalibration();
-  }
-  else if (cmd == "STOP" || cmd == "DONE") {
-    if (calibration.isCalibrating) {
-      calibration.stopCalibration();
-      printHelp();
+// GET [name]
+void cmdGet(const CommandArgs& args, int) {
+  if (args.count < 2) {
+    for (int i = 0; i < PARAM_COUNT; i++) {
+      printParam((ParamId)i);
     }
+    if (params.isDirty()) {
+      logger.println("(changed since last SAVE)");
+    }
+    return;
   }
-  else if (cmd == "CLEAR") {
-    calibration.clearEEPROM();
-    Serial.println("EEPROM cleared.");
-    calibration.startCalibration();
-  }
-  else if (cmd == "DEBUG" || cmd == "D") {
-    gestureDebug = !gestureDebug;
-    Serial.print("Gesture debug: ");
-    Serial.println(gestureDebug ? "ON" : "OFF");
-  }
-  else if (cmd == "HOME" || cmd == "MENU" || cmd == "M") {
-    currentMode = MODE_HOME;
-    Serial.println("Mode: HOME (Paused)");
-    printHelp();
-  }
-  else if (cmd == "GESTURE" || cmd == "G") {
-    currentMode = MODE_GESTURE;
-    Serial.println("Mode: GESTURE RECOGNITION");
+  int id = ParamRegistry::find(args.word[1]);
+  if (id < 0) {
+    logger.print("Unknown parameter: ");
+    logger.copyln(args.word[1]);
+    return;
   }
-  else if (cmd == "PIANO1" || cmd == "P1") {
-    currentMode = MODE_PIANO_SINGLE;
-    Serial.println("Mode: PIANO - Single Notes (one finger = one note)");
+  printParam((ParamId)id);
+}
+
+// SET <name> <value>
+void cmdSet(const CommandArgs& args, int) {
+  if (args.count < 3) {
+    logger.println("Usage: SET <name> <value>  (GET lists names)");
+    return;
   }
-  else if (cmd == "PIANO2" || cmd == "P2") {
-    currentMode = MODE_PIANO_PITCH;
-    Serial.println("Mode: PIANO - Pitch Control (bend = pitch)");
+  int id = ParamRegistry::find(args.word[1]);
+  if (id < 0) {
+    logger.print("Unknown parameter: ");
+    logger.copyln(args.word[1]);
+    return;
   }
-  else if (cmd == "PIANO3" || cmd == "P3") {
-    currentMode = MODE_PIANO_CHORD;
-    Serial.println("Mode: PIANO - Chord Mode");
+  char* end;
+  float value = strtof(args.word[2], &end);
+  const ParamDef& def = ParamRegistry::def((ParamId)id);
+  if (end == args.word[2] || *end || !(value >= def.minValue && value <= def.maxValue)) {
+    logger.println("%s: expected %g to %g", def.name, def.minValue, def.maxValue);
+    return;
   }
-  else if (cmd == "RAW" || cmd == "R") {
-    currentMode = MODE_RAW;
-    Serial.println("Mode: RAW DATA");
+  #ifdef ENABLE_PIANO
+  // Note hysteresis must stay the right way round, or notes stick / chatter
+  long rounded = (long)(value + 0.5f);
+  if ((id == PARAM_PIANO_ON && rounded <= params.getInt(PARAM_PIANO_OFF)) ||
+      (id == PARAM_PIANO_OFF && rounded >= params.getInt(PARAM_PIANO_ON))) {
+    logger.println("piano.off must stay below piano.on (now %d / %d)",
+                   params.getInt(PARAM_PIANO_OFF), params.getInt(PARAM_PIANO_ON));
+    return;
   }
-  else if (cmd == "VR" || cmd == "OPENGLOVES" || cmd == "OG") {
-    currentMode = MODE_OPENGLOVES;
-    Serial.println("Mode: OPENGLOVES (SteamVR)");
-    #ifdef ENABLE_IMU
-    if (imuEnabled) {
-      Serial.println("  IMU: Enabled - sending orientation data");
-    } else {
-      Serial.println("  IMU: Not available - fingers only");
-    }
-    #else
-    Serial.println("  IMU: Disabled in Config.h");
-    #endif
+  #endif
+  params.set((ParamId)id, value);
+  applyParams();
+  printParam((ParamId)id);
+}
+
+void cmdSave(const CommandArgs&, int) {
+  if (params.save()) {
+    logger.println("Parameters saved.");
+  } else {
+    logger.println("Could not save parameters.");
   }
-  else if (cmd == "IMU") {
-    #ifdef ENABLE_IMU
-    if (imuEnabled) {
-      imu.printData();
-    } else {
-      Serial.println("IMU not initialized. Check wiring.");
-    }
-    #else
-    Serial.println("IMU disabled in Config.h");
-    #endif
+}
+
+void cmdDefaults(const CommandArgs&, int) {
+  params.resetDefaults();
+  params.clearSaved();
+  applyParams();
+  logger.println("Parameters reset to defaults.");
+}
+
+const CommandDef COMMANDS[] = {
+  {"CAL",                cmdCalibrate,       0},
+  {"STOP|DONE",          cmdStopCalibration, 0},
+  {"CLEAR",              cmdClear,           0},
+  {"HOME|MENU|M",        cmdMode,            MODE_HOME},
+#ifdef ENABLE_GESTURES
+  {"DEBUG|D",            cmdDebug,           0},
+  {"GESTURE|G",          cmdMode,            MODE_GESTURE},
+#endif
+#ifdef ENABLE_PIANO
+  {"PIANO1|P1",          cmdMode,            MODE_PIANO_SINGLE},
+  {"PIANO2|P2",          cmdMode,            MODE_PIANO_PITCH},
+  {"PIANO3|P3",          cmdMode,            MODE_PIANO_CHORD},
+#endif
+  {"RAW|R",              cmdMode,            MODE_RAW},
+#ifdef ENABLE_OPENGLOVES
+  {"VR|OPENGLOVES|OG",   cmdMode,            MODE_OPENGLOVES},
+  {"VR+|OG+",            cmdOverlay,         0},
+#endif
+  {"IMU",                cmdImu,             0},
+  {"IMUCAL",             cmdImuCalibrate,    0},
+#ifdef FILTER_PROFILE_FULL
+  {"FILTER|F",           cmdFilter,          0},
+#endif
+  {"QOS|LOAD",           cmdQos,             0},
+  {"STATS",              cmdStats,           0},
+  {"POWER",              cmdPower,           0},
+  {"NOISE",              cmdNoise,           0},
+  {"FEATURES|FEAT",      cmdFeatures,        0},
+  {"GET|PARAMS",         cmdGet,             0},
+  {"SET",                cmdSet,             0},
+  {"SAVE",               cmdSave,            0},
+  {"DEFAULTS",           cmdDefaults,        0},
+  {"BT",                 cmdBluetooth,       0},
+  {"TRACE",              cmdTrace,           0},
+  {"SYNC",               cmdSync,            0},
+  {"BUILD",              cmdBuild,           0},
+  {"HELP|H|?",           cmdHelp,            0},
+};
+
+void handleCommands() {
+  // Serial's receive interrupt buffers the bytes; lines are assembled in place
+  if (Serial.available()) {
+    power.noteInput(millis());
   }
-  else if (cmd == "IMUCAL") {
-    #ifdef ENABLE_IMU
-    if (imuEnabled) {
-      Serial.println("Calibrating IMU... Keep device still!");
-      imu.calibrate(500);
+  while (Serial.available()) {
+    if (commandLine.feed(Serial.read())) {
+      processCommand(commandLine.parse());
     }
-    #endif
-  }
-  else if (cmd == "BT") {
-    comm.toggleBluetooth();
-  }
-  else if (cmd == "HELP" || cmd == "H" || cmd == "?") {
-    printHelp();
   }
-  else if (calibration.isCalibrating) {
+}
+
+void processCommand(const CommandArgs& args) {
+  if (args.count == 0) return;
+  if (CommandLine::dispatch(COMMANDS, sizeof(COMMANDS) / sizeof(COMMANDS[0]), args)) return;
+
+  if (calibration.isCalibrating) {
     // Any other input stops calibration
     calibration.stopCalibration();
     printHelp();
+  } else {
+    logger.print("Unknown command: ");
+    logger.copyln(args.word[0]);
+    logger.println("Type 'HELP' for commands.");
   }
-  else {
-    Serial.print("Unknown command: ");
-    Serial.println(cmd);
-    Serial.println("Type 'HELP' for commands.");
+}
+
+// Push the registry's values into the modules that use them
+void applyParams() {
+  acquisition.setTuning(params.filterTuning());
+  #ifdef ENABLE_GESTURES
+  gestureRecognizer.getStaticMatcher().setDebounceFrames(params.getInt(PARAM_GESTURE_DEBOUNCE));
+  #endif
+  #ifdef ENABLE_PIANO
+  airPiano.setThresholds(params.getInt(PARAM_PIANO_ON), params.getInt(PARAM_PIANO_OFF));
+  airPiano.setVelocityCurve(params.get(PARAM_PIANO_SPEED), params.getInt(PARAM_PIANO_MIN_VELOCITY));
+  #endif
+}
+
+void printParam(ParamId id) {
+  const ParamDef& def = ParamRegistry::def(id);
+  if (def.integer) {
+    logger.println("%-14s %d %s (default %d)", def.name, params.getInt(id), def.unit,
+                   (int)def.defaultValue);
+  } else {
+    logger.println("%-14s %g %s (default %g)", def.name, params.get(id), def.unit,
+                   def.defaultValue);
   }
 }
 
 void printHelp() {
-  Serial.println();
-  Serial.println("============ COMMANDS ============");
-  Serial.println("CAL      - Start calibration");
-  Serial.println("CLEAR    - Clear EEPROM & recalibrate");
-  Serial.println();
-  Serial.println("--- Modes ---");
-  Serial.println("M/HOME   - Main menu (pause)");
-  Serial.println("G        - Gesture recognition mode");
-  Serial.println("P1       - Piano: Single notes");
-  Serial.println("P2       - Piano: Pitch control");
-  Serial.println("P3       - Piano: Chord mode");
-  Serial.println("R        - Raw data mode");
-  Serial.println("VR       - OpenGloves mode (SteamVR)");
-  Serial.println();
-  Serial.println("--- Hardware ---");
-  Serial.println("BT       - Toggle Bluetooth");
+  logger.println();
+  logger.println("============ COMMANDS ============");
+  logger.println("CAL      - Start calibration");
+  logger.println("CLEAR    - Clear EEPROM & recalibrate");
+  logger.println();
+  logger.println("--- Modes ---");
+  logger.println("M/HOME   - Main menu (pause)");
+  #ifdef ENABLE_GESTURES
+  logger.println("G        - Gesture recognition mode");
+  #endif
+  #ifdef ENABLE_PIANO
+  logger.println("P1       - Piano: Single notes");
+  logger.println("P2       - Piano: Pitch control");
+  logger.println("P3       - Piano: Chord mode");
+  #endif
+  logger.println("R        - Raw data mode");
+  #ifdef ENABLE_OPENGLOVES
+  logger.println("VR       - OpenGloves mode (SteamVR)");
+  logger.println("VR+      - Toggle OpenGloves alongside G/P1-3/R");
+  #endif
+  logger.println();
+  logger.println("--- Hardware ---");
+  #ifdef ENABLE_BLUETOOTH
+  logger.println("BT       - Toggle Bluetooth");
+  #endif
+  #ifdef FILTER_PROFILE_FULL
+  logger.println("F/FILTER - Cycle filter (EMA / One-Euro / Kalman)");
+  #endif
+  logger.println("NOISE    - Show per-finger noise and auto-tuned smoothing");
+  logger.println("FEAT     - Show per-finger motion features");
+  logger.println("QOS      - Show frame budget, overruns and load shedding");
+  #ifdef ENABLE_PROFILER
+  logger.println("STATS    - Show time per pipeline stage (STATS RESET: start over)");
+  #endif
+  logger.println("TRACE    - Stamp messages with frame number and capture time");
+  logger.println("POWER    - Show power state (CPU clock, idle time)");
+  logger.println("BUILD    - Show build profile, flash/RAM use and boot time");
+  logger.println();
+  logger.println("--- Parameters ---");
+  logger.println("GET [name]       - Show tunable parameters");
+  logger.println("SET name value   - Change one now");
+  logger.println("SAVE / DEFAULTS  - Keep them across reboots / reset all");
   #ifdef ENABLE_IMU
-  Serial.println("IMU      - Show IMU data");
-  Serial.println("IMUCAL   - Calibrate IMU");
-  Serial.print("IMU Status: ");
-  Serial.println(imuEnabled ? "OK" : "Not found");
+  logger.println("IMU      - Show IMU data");
+  logger.println("IMUCAL   - Calibrate IMU");
+  logger.println("IMU Status: %s", imuEnabled ? "OK" : "Not found");
+  #endif
+  logger.println();
+  logger.println("HELP     - Show this help");
+  logger.println("==================================");
+  logger.println();
+}
+
+void printNoise() {
+  AutoSmoothStage* tuner = analogFilter.getAutoSmooth();
+  if (!tuner) {
+    logger.println("Noise auto-tune not in this build (FILTER_AUTO_TUNE).");
+    return;
+  }
+
+  logger.println("Sensor  sigma  alpha  deadzone");
+  for (int i = 0; i < SENSOR_COUNT; i++) {
+    if (!tuner->isTuned(i)) {
+      logger.println("%s  (waiting for rest)", SENSOR_NAMES[i]);
+      continue;
+    }
+    logger.println("%s  %.1f   %.2f   %d", SENSOR_NAMES[i],
+                   tuner->getSigma(i), tuner->getAlpha(i), tuner->getDeadzone(i));
+  }
+}
+
+void printFeatures() {
+  logger.println("Window %d ms @ %u Hz", FEATURE_WINDOW_MS, fingerFeatures.getRate());
+  logger.println("Sensor  mean  sd    min   max   vel/s   acc/s2  still");
+  for (int i = 0; i < SENSOR_COUNT; i++) {
+    logger.println("%s  %.0f  %.1f  %d  %d  %.0f  %.0f  %s", SENSOR_NAMES[i],
+                   fingerFeatures.getMean(i), sqrt(fingerFeatures.getVariance(i)),
+                   fingerFeatures.getMin(i), fingerFeatures.getMax(i),
+                   fingerFeatures.getVelocity(i), fingerFeatures.getAcceleration(i),
+                   fingerFeatures.isStill(i) ? "yes" : "no");
+  }
+}
+
+void printQos() {
+  logger.println("QoS level %d (%s)", qos.getLevel(), QosGovernor::levelName(qos.getLevel()));
+  logger.println("Budget %lu us, worst %lu us, load %d%%",
+                 qos.getBudgetUs(), qos.getWorstUs(), qos.getLoad());
+  logger.println("Overruns %lu / %lu frames, %u level changes",
+                 qos.getOverruns(), qos.getFrames(), qos.getLevelChanges());
+  qos.resetStats();
+}
+
+void printStats(bool reset) {
+  #ifdef ENABLE_PROFILER
+  #ifdef ESP32
+  uint32_t mhz = getCpuFrequencyMhz();
+  logger.println("Stage        count      min      avg      max      p99  (%s, p99 us at %u MHz)",
+                 PROFILE_UNIT, mhz);
+  #else
+  logger.println("Stage        count      min      avg      max      p99  (%s)", PROFILE_UNIT);
+  #endif
+  for (int i = 0; i < PROF_STAGE_COUNT; i++) {
+    Profiler::Summary s;
+    if (!profiler.summarize((ProfileStage)i, s)) continue;
+    #ifdef ESP32
+    logger.println("%-8s %9lu %8lu %8lu %8lu %8lu  %.1f", Profiler::stageName((ProfileStage)i),
+                   s.count, s.min, s.avg, s.max, s.p99, (float)s.p99 / mhz);
+    #else
+    logger.println("%-8s %9lu %8lu %8lu %8lu %8lu", Profiler::stageName((ProfileStage)i),
+                   s.count, s.min, s.avg, s.max, s.p99);
+    #endif
+  }
+  if (reset) {
+    profiler.reset();
+    logger.println("Profiler reset.");
+  }
+  #else
+  (void)reset;
+  logger.println("Profiler disabled in Config.h");
+  #endif
+}
+
+void printPower() {
+  #ifdef ENABLE_POWER_SAVE
+  uint32_t now = millis();
+  logger.println("Power: %s, CPU %u MHz (active %u MHz)", power.isIdle() ? "IDLE" : "ACTIVE",
+                 power.getCpuMhz(), power.getActiveMhz());
+  logger.println("Idle %lu of %lu s, %u wakes", power.getIdleMs(now) / 1000, now / 1000,
+                 power.getWakeCount());
+  #else
+  logger.println("Power saving disabled in Config.h");
+  #endif
+}
+
+// Subsystems compiled into this build
+const char* const BUILD_FEATURES = ""
+#ifdef ENABLE_GESTURES
+  " gestures"
+#endif
+#ifdef ENABLE_PIANO
+  " piano"
+#endif
+#ifdef ENABLE_OPENGLOVES
+  " opengloves"
+#endif
+#ifdef ENABLE_PROFILER
+  " profiler"
+#endif
+#ifdef ENABLE_BLUETOOTH
+  " bluetooth"
+#endif
+#ifdef ENABLE_IMU
+  " imu"
+#endif
+#ifdef ENABLE_POWER_SAVE
+  " power-save"
+#endif
+#ifdef ENABLE_FAST_BOOT
+  " fast-boot"
+#endif
+  ;
+
+// Size and startup cost of the build profile
+void printBuild() {
+  logger.println("Build: %s profile, filter %s", VLOVE_PROFILE_NAME,
+                 AnalogFilter::modeName(acquisition.getFilterMode()));
+  logger.println("Boot: setup %lu ms, first frame %lu ms (since app start)", bootMs, firstFrameMs);
+  logger.println("Features:%s", BUILD_FEATURES);
+  #ifdef ESP32
+  logger.println("Flash: sketch %u KB, %u KB free", ESP.getSketchSize() / 1024,
+                 ESP.getFreeSketchSpace() / 1024);
+  logger.println("RAM: heap %u KB free of %u KB (lowest %u KB)", ESP.getFreeHeap() / 1024,
+                 ESP.getHeapSize() / 1024, ESP.getMinFreeHeap() / 1024);
   #endif
-  Serial.println();
-  Serial.println("HELP     - Show this help");
-  Serial.println("==================================");
-  Serial.println();
 }
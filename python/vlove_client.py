@@ -10,6 +10,7 @@ Commands:
     python vlove_client.py /dev/cu.usbserial-110
     python vlove_client.py --bt               # Use Bluetooth
     python vlove_client.py --list             # List available ports
+    python vlove_client.py --trace            # Latency / loss report (firmware TRACE mode)
 """
 
 import serial
@@ -23,6 +24,12 @@ from audio_player import AudioPlayer
 DEFAULT_BAUD = 115200
 BT_DEVICE_NAME = "vlove-left"
 
+# Trace mode
+TRACE_SYNC_S = 2.0          # Clock sample (SYNC) interval
+TRACE_SYNC_WINDOW = 8       # Syncs kept; the one with the shortest round trip sets the offset
+TRACE_REPORT_S = 5.0        # Report interval
+LATENCY_BINS_MS = [1, 2, 5, 10, 20, 50, 100, 200, 500]
+
 # Gesture names for display
 GESTURE_NAMES = {
     0: "None",
@@ -40,13 +47,141 @@ GESTURE_NAMES = {
 }
 
 
+class TraceStats:
+    """Latency and loss from trace-mode stamps
+
+    With TRACE on, every protocol line ends in @<line>,<seq>,<capture_us>.
+    - <line> counts messages on the link, so a gap is a message that was lost.
+    - <seq> is the frame number on its stream.
+    - <capture_us> is when the frame's ADC sample was taken, on the glove's
+      micros() clock.
+    SYNC replies T,<micros> and maps that clock onto ours. The offset comes
+    from the sync with the shortest round trip among the last few, so it
+    follows crystal drift. Latencies are accurate to about half that round
+    trip.
+    """
+
+    def __init__(self):
+        self.syncs = []             # (round trip, device us, host us at mid-flight)
+        self.sync_sent = None
+        self.last_line = None
+        self.last_seq = {}          # message type -> last frame number
+        self.reset()
+
+    def reset(self):
+        """Start the next report period"""
+        self.latency = {}           # message type -> latencies (ms)
+        self.messages = 0
+        self.lost = 0
+        self.skipped = {}           # message type -> frames not sent
+        self.started = time.perf_counter()
+
+    @staticmethod
+    def split(line):
+        """(message, (line, seq, capture_us)) or (line, None) if not stamped"""
+        message, sep, stamp = line.rpartition('@')
+        if not sep:
+            return line, None
+        try:
+            number, seq, capture_us = (int(v) for v in stamp.split(','))
+        except ValueError:
+            return line, None
+        return message, (number, seq, capture_us)
+
+    @staticmethod
+    def now_us():
+        return time.perf_counter() * 1e6
+
+    def sync_sent_at(self, host_us):
+        self.sync_sent = host_us
+
+    def on_sync(self, line, host_us):
+        """T,<device micros> arrived at host_us"""
+        if self.sync_sent is None:
+            return
+        try:
+            device_us = int(line.split(',')[1])
+        except (IndexError, ValueError):
+            return
+        rtt = host_us - self.sync_sent
+        self.sync_sent = None
+        self.syncs.append((rtt, device_us, host_us - rtt / 2))
+        del self.syncs[:-TRACE_SYNC_WINDOW]
+
+    def record(self, kind, stamp, host_us):
+        number, seq, capture_us = stamp
+
+        # Link loss from the message counter (restarts when TRACE is turned on again)
+        lost = 0
+        if self.last_line is not None and number > self.last_line:
+            lost = number - self.last_line - 1
+        self.lost += lost
+        self.last_line = number
+        self.messages += 1
+
+        # Continuous OpenGloves frames: a seq gap not explained by lost
+        # messages is a frame the glove didn't send
+        if kind == 'A':
+            last = self.last_seq.get(kind)
+            if last is not None and seq > last + 1 + lost:
+                self.skipped[kind] = self.skipped.get(kind, 0) + seq - last - 1 - lost
+            self.last_seq[kind] = seq
+
+        if not self.syncs:
+            return
+        _, device_us, host_mid = min(self.syncs)
+        delta = (capture_us - device_us + 2**31) % 2**32 - 2**31   # micros() wraps every 71 min
+        latency_ms = (host_us - (host_mid + delta)) / 1000.0
+        self.latency.setdefault(kind, []).append(latency_ms)
+
+    def report(self):
+        elapsed = time.perf_counter() - self.started
+        print()
+        print(f"--- Trace: {self.messages} messages in {elapsed:.1f} s, "
+              f"{self.lost} lost on the link", end='')
+        if self.messages + self.lost > 0:
+            print(f" ({100.0 * self.lost / (self.messages + self.lost):.2f}%)", end='')
+        print(" ---")
+        if self.syncs:
+            print(f"Clock sync round trip {min(self.syncs)[0] / 1000.0:.1f} ms "
+                  f"(latencies +/- half of it)")
+        else:
+            print("No SYNC reply yet: latencies pending")
+        for kind, skipped in sorted(self.skipped.items()):
+            print(f"{kind}: {skipped} frames not sent (glove-side skips, e.g. QoS)")
+
+        for kind, values in sorted(self.latency.items()):
+            values.sort()
+            n = len(values)
+            pick = lambda q: values[min(n - 1, int(q * n))]
+            print(f"{kind}: n={n}  p50 {pick(0.50):.1f}  p95 {pick(0.95):.1f}  "
+                  f"p99 {pick(0.99):.1f}  max {values[-1]:.1f} ms")
+            counts = [0] * (len(LATENCY_BINS_MS) + 1)
+            for v in values:
+                i = 0
+                while i < len(LATENCY_BINS_MS) and v >= LATENCY_BINS_MS[i]:
+                    i += 1
+                counts[i] += 1
+            lower = 0
+            for i, count in enumerate(counts):
+                label = (f"{lower}-{LATENCY_BINS_MS[i]}" if i < len(LATENCY_BINS_MS)
+                         else f"{lower}+")
+                if count:
+                    bar = '#' * max(1, round(40 * count / n))
+                    print(f"  {label:>8} ms {count:7d} {bar}")
+                if i < len(LATENCY_BINS_MS):
+                    lower = LATENCY_BINS_MS[i]
+        self.reset()
+
+
 class VloveClient:
-    def __init__(self, port=None, use_bluetooth=False):
+    def __init__(self, port=None, use_bluetooth=False, trace=False):
         self.port = port
         self.use_bluetooth = use_bluetooth
         self.serial = None
         self.running = False
         self.audio = AudioPlayer()
+        self.trace = TraceStats() if trace else None
 
     def find_usb_port(self):
         """Auto-detect USB serial port"""
@@ -204,16 +339,34 @@ class VloveClient:
         input_thread.daemon = True
         input_thread.start()
 
+        if self.trace:
+            self.serial.write(b'TRACE ON\n')
+            last_sync = last_report = time.perf_counter()
+
         # Main loop
         try:
             while self.running:
                 self.process_serial()
-                time.sleep(0.01)
+                if not self.trace:
+                    time.sleep(0.01)
+                    continue
+                # Trace: read without pausing, or the pause shows up as latency
+                now = time.perf_counter()
+                if now - last_sync >= TRACE_SYNC_S:
+                    last_sync = now
+                    self.trace.sync_sent_at(TraceStats.now_us())
+                    self.serial.write(b'SYNC\n')
+                if now - last_report >= TRACE_REPORT_S:
+                    last_report = now
+                    self.trace.report()
         except KeyboardInterrupt:
             print("\nExiting...")
         finally:
             self.running = False
             if self.serial:
+                if self.trace:
+                    self.serial.write(b'TRACE OFF\n')
+                    self.trace.report()
                 self.serial.close()
             self.audio.stop()
 
@@ -236,9 +389,17 @@ class VloveClient:
 
         try:
             line = self.serial.readline().decode('utf-8', errors='ignore').strip()
+            received_us = TraceStats.now_us()
             if not line:
                 return
 
+            stamp = None
+            if self.trace:
+                if line.startswith('T,'):
+                    self.trace.on_sync(line, received_us)
+                    return
+                line, stamp = TraceStats.split(line)
+
             # Parse data based on prefix
             if line.startswith('G,'):
                 self.handle_gesture(line)
@@ -246,10 +407,15 @@ class VloveClient:
                 self.handle_piano(line)
             elif line.startswith('R,'):
                 self.handle_raw(line)
+            elif line.startswith('A') and stamp:
+                pass    # OpenGloves frame, only read for its trace stamp
             else:
                 # Pass through other messages (calibration, help, etc.)
                 print(line)
 
+            if stamp:
+                self.trace.record(line[0], stamp, received_us)
+
         except serial.SerialException:
             print("\nConnection lost. Exiting...")
             self.running = False
@@ -315,11 +481,12 @@ class VloveClient:
             print(f"Error parsing piano: {e}")
 
     def handle_raw(self, line):
-        """Handle raw data: R,raw0,...,raw4,mapped0,...,mapped4"""
+        """Handle raw data: R,raw0,...,rawN-1,mapped0,...,mappedN-1 (N sensors)"""
         try:
-            parts = line.split(',')
-            raw = [int(parts[i]) for i in range(1, 6)]
-            mapped = [int(parts[i]) for i in range(6, 11)]
+            values = [int(v) for v in line.split(',')[1:]]
+            count = len(values) // 2
+            raw = values[:count]
+            mapped = values[count:2 * count]
 
             # Simple visualization
             bar = ""
@@ -344,6 +511,8 @@ Usage:
 Options:
     --bt, -b        Connect via Bluetooth
     --list, -l      List available ports
+    --trace, -t     Turn on firmware TRACE mode and report latency
+                    (capture to receipt) and message loss every 5 s
     --help, -h      Show this help
 
 Examples:
@@ -364,6 +533,7 @@ def main():
     port = None
     use_bt = False
     list_only = False
+    trace = False
 
     # Parse arguments
     for arg in sys.argv[1:]:
@@ -371,6 +541,8 @@ def main():
             use_bt = True
         elif arg in ('--list', '-l'):
             list_only = True
+        elif arg in ('--trace', '-t'):
+            trace = True
         elif arg in ('--help', '-h'):
             print_help()
             return
@@ -384,7 +556,7 @@ def main():
         return
 
     # Start client
-    client = VloveClient(port, use_bt)
+    client = VloveClient(port, use_bt, trace)
     client.start()
 
 